@@ -0,0 +1,1643 @@
+#include "persons.h"
+#include "traits.h"
+#include "interning.cpp"
+#include "date.cpp"
+#include "formatting.cpp"
+#include "validation.cpp"
+#include "payroll.cpp"
+#include "instrumentation.cpp"
+#include "university.cpp"
+#include "persons.cpp"
+#include "roster.cpp"
+#include "registration.cpp"
+#include "snapshot.cpp"
+#include "journal.cpp"
+#include "statistics.cpp"
+#include "change_stream.cpp"
+#include "federation.cpp"
+#include "versioned_view.cpp"
+#include "csv_import.cpp"
+#include "person_index.h"
+#include "statistics.h"
+#include "change_stream.h"
+#include "federation.h"
+#include "versioned_view.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <sys/resource.h>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Benchmarks für das Campus Management. Übersetzt wird die Datei genauso wie
+ * main.cpp, z.B. mit: g++ -O2 -std=c++17 benchmark.cpp -o benchmark
+ *
+ * Aufruf: benchmark [maximale Größe], Standard ist 1000000. Jede Messung wird
+ * als eine JSON Zeile auf der Standardausgabe ausgegeben, mit den Feldern
+ * benchmark, size, ops, ns_per_op, allocs_per_op und peak_rss_kb sowie
+ * eventuell weiteren Kennzahlen der Messung.
+ *
+ * Mit -DCAMPUS_INSTRUMENTATION übersetzt folgt zum Schluss eine weitere Zeile
+ * mit den Zählern und Laufzeitverteilungen aller instrumentierten Operationen.
+ */
+
+typedef std::chrono::steady_clock bench_clock;
+
+static std::atomic<std::size_t> s_allocations(0);
+static thread_local std::size_t s_thread_allocations = 0;
+
+/*
+ * Alle Formen von new und delete laufen über malloc und free, damit die
+ * Paare zueinander passen und auch Felder wie die Blöcke von Pool und
+ * EnrollmentTable gezählt werden.
+ */
+static void *counted_allocate(std::size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	s_thread_allocations++;
+	void *ptr = std::malloc(size != 0 ? size : 1);
+	if(ptr == NULL)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void *operator new(std::size_t size)
+{
+	return counted_allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+	return counted_allocate(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+static double elapsed_ns(bench_clock::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(bench_clock::now() - start).count();
+}
+
+/*
+ * Startpunkt einer Messung, merkt sich Zeit und Anzahl der bisherigen
+ * Speicheranforderungen im ganzen Prozess sowie im erzeugenden Thread.
+ */
+struct Timer {
+	bench_clock::time_point start;
+	std::size_t allocations;
+	std::size_t thread_allocations;
+
+	Timer(): start(bench_clock::now()), allocations(s_allocations.load()), thread_allocations(s_thread_allocations){}
+};
+
+/*
+ * Ergebnis einer Messung welche nur die Speicheranforderungen des messenden
+ * Threads zählt. Muss in dem Thread erzeugt werden, welcher den Timer
+ * angelegt hat.
+ */
+struct ThreadMeasurement {
+	double ns;
+	std::size_t allocations;
+
+	explicit ThreadMeasurement(const Timer &timer):
+		ns(elapsed_ns(timer.start)), allocations(s_thread_allocations - timer.thread_allocations){}
+};
+
+/*
+ * Gibt eine Messung als JSON Zeile aus. extra wird unverändert als weitere
+ * Felder angehängt und muss mit einem Komma beginnen.
+ */
+static void report(const char *name, std::size_t size, std::size_t ops, const ThreadMeasurement &measurement,
+	const std::string &extra = "")
+{
+	double ns = measurement.ns;
+	std::size_t allocations = measurement.allocations;
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+
+	ops = std::max<std::size_t>(ops, 1);
+	std::printf("{\"benchmark\":\"%s\",\"size\":%zu,\"ops\":%zu,\"ns_per_op\":%.1f,"
+		"\"allocs_per_op\":%.2f,\"peak_rss_kb\":%ld%s}\n",
+		name, size, ops, ns / ops, static_cast<double>(allocations) / ops,
+		usage.ru_maxrss, extra.c_str());
+	std::fflush(stdout);
+}
+
+/*
+ * Gibt eine Messung aus, bei welcher die Speicheranforderungen aller Threads
+ * zählen.
+ */
+static void report(const char *name, std::size_t size, std::size_t ops, const Timer &timer, const std::string &extra = "")
+{
+	ThreadMeasurement measurement(timer);
+	measurement.allocations = s_allocations.load() - timer.allocations;
+	report(name, size, ops, measurement, extra);
+}
+
+static std::string field(const char *name, double value)
+{
+	char buffer[64];
+	std::snprintf(buffer, sizeof(buffer), ",\"%s\":%.2f", name, value);
+	return buffer;
+}
+
+static std::vector<std::unique_ptr<Student>> make_students(Address &address, std::size_t count)
+{
+	Date birthday = Date::today().add_years(-20);
+	std::vector<std::unique_ptr<Student>> students;
+	students.reserve(count);
+	for(std::size_t i = 0; i < count; i++)
+		students.emplace_back(new Student("Bench", "Student", birthday, address));
+	return students;
+}
+
+/*
+ * Nachbildung der alten Mitgliederverwaltung: lineare Suche über die
+ * Matrikelnummer und Löschen aus der Mitte des Vektors.
+ */
+static void old_enroll(std::vector<Student *> &students, Student &student)
+{
+	for(const auto &ptr : students)
+		if(ptr->student_number() == student.student_number())
+			return;
+	students.emplace_back(&student);
+}
+
+static void old_exmatriculate(std::vector<Student *> &students, Student &student)
+{
+	int pos = 0;
+	for(const auto &ptr : students)
+	{
+		if(ptr->student_number() == student.student_number())
+		{
+			students.erase(students.begin() + pos);
+			return;
+		}
+		pos++;
+	}
+}
+
+/*
+ * Misst Immatrikulation und Exmatrikulation gegen eine Universität mit
+ * members Studierenden. Gemessen werden jeweils ops Operationen auf zufällig
+ * gewählten Mitgliedern, da der alte Pfad bei 1M Mitgliedern sonst Stunden
+ * dauern würde.
+ */
+static void bench_membership(std::size_t members, std::size_t ops)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, members);
+	std::vector<Student *> old_students;
+
+	for(auto &student : students)
+		university.enroll(*student);
+	old_students = university.list_students();
+
+	std::vector<std::size_t> picks(ops);
+	for(std::size_t i = 0; i < ops; i++)
+		picks[i] = (i * 2654435761u) % members;
+
+	Timer registry;
+	for(std::size_t i : picks)
+	{
+		university.exmatriculate(*students[i]);
+		university.enroll(*students[i]);
+	}
+	report("membership_registry", members, 2 * ops, registry);
+
+	Timer linear;
+	for(std::size_t i : picks)
+	{
+		old_exmatriculate(old_students, *students[i]);
+		old_enroll(old_students, *students[i]);
+	}
+	report("membership_linear", members, 2 * ops, linear);
+}
+
+/*
+ * Misst das Rendern einer Universität mit students Studierenden, jeweils
+ * einmal über to_string und über einen wiederverwendeten Puffer. Gemessen
+ * wird die Übersicht der Universität und die Darstellung aller Studierenden.
+ */
+static void bench_render(std::size_t students_count, int rounds)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, students_count);
+	for(auto &student : students)
+		university.enroll(*student);
+
+	for(int part = 0; part < 2; part++)
+	{
+		std::size_t ops = part == 0 ? rounds : rounds * students_count;
+		std::size_t bytes = 0;
+		Timer string_timer;
+		for(int r = 0; r < rounds; r++)
+		{
+			if(part == 0)
+				bytes += university.to_string().size();
+			else for(auto &student : students)
+				bytes += student->to_string().size();
+		}
+		double string_s = elapsed_ns(string_timer.start) / 1e9;
+		report(part == 0 ? "render_university_to_string" : "render_students_to_string",
+			students_count, ops, string_timer, field("mb_per_s", bytes / string_s / 1e6));
+
+		std::string buffer;
+		bytes = 0;
+		Timer buffer_timer;
+		for(int r = 0; r < rounds; r++)
+		{
+			buffer.clear();
+			if(part == 0)
+				university.append_to(buffer);
+			else for(auto &student : students)
+				student->append_to(buffer);
+			bytes += buffer.size();
+		}
+		double buffer_s = elapsed_ns(buffer_timer.start) / 1e9;
+		report(part == 0 ? "render_university_append_to" : "render_students_append_to",
+			students_count, ops, buffer_timer, field("mb_per_s", bytes / buffer_s / 1e6));
+	}
+}
+
+/*
+ * Nachbildung der bisherigen Darstellung eines Studierenden, das Datum über
+ * std::asctime und jedes Stück einzeln an den Puffer gehängt. Nicht
+ * threadsicher, da std::asctime einen gemeinsamen statischen Puffer nutzt.
+ */
+static void old_append_student(std::string &buffer, Student &student)
+{
+	CivilDate date = student.birthday().civil();
+	std::tm birthday_tm = {};
+	birthday_tm.tm_year = date.year - 1900;
+	birthday_tm.tm_mon = date.month - 1;
+	birthday_tm.tm_mday = date.day;
+	birthday_tm.tm_wday = student.birthday().weekday();
+
+	buffer += '\n';
+	buffer += student.first_name();
+	buffer += ' ';
+	buffer += student.last_name();
+	buffer += '\n';
+	buffer += std::asctime(&birthday_tm);
+	buffer += '\n';
+	const Address &address = student.place_of_residence();
+	buffer += address.street();
+	buffer += ' ';
+	append_number(buffer, address.street_no());
+	buffer += '\n';
+	buffer += address.zip_code();
+	buffer += ' ';
+	buffer += address.city();
+	buffer += '\n';
+	buffer += address.country();
+	buffer += '\n';
+
+	buffer += "\nUniversität: ";
+	if(student.university() != NULL)
+		buffer += student.university()->name();
+	buffer += "\n\nMatrikelnummer: ";
+	append_number(buffer, student.student_number());
+	buffer += "\n\nAnzahl Seminare: ";
+	append_number(buffer, student.list_courses().size());
+	buffer += '\n';
+	std::size_t i = 0;
+	for(Course *course : student.list_courses())
+	{
+		append_number(buffer, ++i);
+		buffer += ' ';
+		buffer += course->name();
+		buffer += '\n';
+	}
+}
+
+/*
+ * Stellt Studierende mit über 40 Jahre verteilten Geburtstagen dar, einmal
+ * mit der bisherigen Darstellung über std::asctime in einem Thread und einmal
+ * über append_to mit einem und mit allen Kernen. Jeder Thread nutzt einen
+ * eigenen Puffer, equal ist 1 wenn alle Darstellungen Byte für Byte der
+ * bisherigen entsprechen.
+ */
+static void bench_formatting(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	Teacher teacher("Bench", "Teacher", Date::today().add_years(-50), address);
+	university.hire(teacher, 5000);
+	std::vector<Course *> courses;
+	for(int i = 0; i < 20; i++)
+		courses.push_back(&university.offer_course(std::string("Benchmark Seminar ") + char('A' + i), teacher));
+
+	std::mt19937 random(24);
+	Date today = Date::today();
+	std::vector<std::unique_ptr<Student>> students;
+	students.reserve(count);
+	for(std::size_t i = 0; i < count; i++)
+	{
+		students.emplace_back(new Student("Bench", "Student", today.add_days(-static_cast<std::int32_t>(6570 + random() % 14600)), address));
+		students.back()->enroll(university);
+		for(int k = 0; k < 3; k++)
+			students.back()->enlist(*courses[random() % courses.size()]);
+	}
+
+	std::vector<std::string> expected(count);
+	std::size_t bytes = 0;
+	Timer old_timer;
+	for(std::size_t i = 0; i < count; i++)
+	{
+		old_append_student(expected[i], *students[i]);
+		bytes += expected[i].size();
+	}
+	double old_s = elapsed_ns(old_timer.start) / 1e9;
+	report("formatting_asctime", count, count, old_timer, field("mb_per_s", bytes / old_s / 1e6));
+
+	std::size_t cores = std::max(2u, std::thread::hardware_concurrency());
+	for(std::size_t threads : {std::size_t(1), cores})
+	{
+		const int rounds = 3;
+		std::atomic<std::size_t> mismatches(0);
+		std::vector<std::thread> workers;
+		Timer timer;
+		for(std::size_t t = 0; t < threads; t++)
+		{
+			workers.emplace_back([&, t](){
+				std::string buffer;
+				std::size_t mismatched = 0;
+				for(int r = 0; r < rounds; r++)
+				{
+					for(std::size_t i = t; i < count; i += threads)
+					{
+						buffer.clear();
+						students[i]->append_to(buffer);
+						mismatched += buffer != expected[i];
+					}
+				}
+				mismatches += mismatched;
+			});
+		}
+		for(std::thread &worker : workers)
+			worker.join();
+		double new_s = elapsed_ns(timer.start) / 1e9;
+		report(threads == 1 ? "formatting_threads_1" : "formatting_threads_all", count, rounds * count, timer,
+			field("threads", threads) + field("mb_per_s", rounds * bytes / new_s / 1e6)
+			+ field("equal", mismatches == 0));
+	}
+}
+
+/*
+ * Zählt die Studierenden pro Geburtsjahr, einmal über die Objekte hinter
+ * list_students() und einmal über die Spalten der Universität.
+ */
+static void bench_birth_years(std::size_t students_count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	std::vector<std::unique_ptr<Student>> students;
+	students.reserve(students_count);
+	Date today = Date::today();
+	for(std::size_t i = 0; i < students_count; i++)
+	{
+		std::int32_t age = 6000 + (i * 7919) % 9000;
+		students.emplace_back(new Student("Bench", "Student", today.add_days(-age), address));
+	}
+	std::vector<Student *> shuffled;
+	for(auto &student : students)
+		shuffled.emplace_back(student.get());
+	std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+	university.enroll_batch(shuffled);
+	university.enable_student_columns();
+
+	Timer objects;
+	std::map<std::int32_t, std::size_t> by_objects;
+	for(Student *student : university.list_students())
+	{
+		std::time_t birthday = std::chrono::system_clock::to_time_t(student->birthday().to_time_point());
+		std::tm date;
+		gmtime_r(&birthday, &date);
+		by_objects[date.tm_year + 1900]++;
+	}
+	report("birth_years_objects", students_count, students_count, objects);
+
+	Timer columns;
+	std::map<std::int32_t, std::size_t> by_columns = university.student_columns()->count_per_birth_year();
+	report("birth_years_columns", students_count, students_count, columns,
+		field("equal", by_objects == by_columns));
+}
+
+/*
+ * Zählt die Studierenden nach Altersstufen und mit Geburtstag in den nächsten
+ * sieben Tagen, einmal über die Objekte mit Date::age_at() und einmal über die
+ * Geburtstagsspalten der Universität.
+ */
+static void bench_age_queries(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	std::vector<std::unique_ptr<Student>> students;
+	students.reserve(count);
+	Date today = Date::today();
+	std::mt19937 random(23);
+	for(std::size_t i = 0; i < count; i++)
+	{
+		std::int32_t age = 365 * 16 + random() % (365 * 60);
+		students.emplace_back(new Student("Bench", "Student", today.add_days(-age), address));
+		students.back()->enroll(university);
+	}
+	university.enable_student_columns();
+
+	const std::vector<std::int32_t> ages = {18, 21, 25, 30, 40, 50, 65};
+	Date week_end = today.add_days(6);
+	Date yesterday = today.add_days(-1);
+	const int rounds = 10;
+
+	std::vector<std::size_t> by_objects(ages.size() + 1, 0);
+	std::size_t week_objects = 0;
+	Timer objects;
+	for(int r = 0; r < rounds; r++)
+	{
+		std::fill(by_objects.begin(), by_objects.end(), 0);
+		week_objects = 0;
+		for(Student *student : university.list_students())
+		{
+			std::int32_t age = student->birthday().age_at(today);
+			by_objects[std::upper_bound(ages.begin(), ages.end(), age) - ages.begin()]++;
+			week_objects += student->birthday().age_at(week_end) != student->birthday().age_at(yesterday);
+		}
+	}
+	report("age_queries_objects", count, rounds, objects);
+
+	const StudentColumns &columns = *university.student_columns();
+	std::vector<std::size_t> by_columns;
+	std::size_t week_columns = 0;
+	Timer column_timer;
+	for(int r = 0; r < rounds; r++)
+	{
+		by_columns = columns.count_age_brackets(today, ages);
+		week_columns = columns.count_birthdays_between(today, week_end);
+	}
+	report("age_queries_columns", count, rounds, column_timer,
+		field("equal", by_objects == by_columns && week_objects == week_columns) + field("this_week", week_columns));
+}
+
+/*
+ * Speicherbedarf eines Strings welcher die Zeichen selbst besitzt, kurze
+ * Strings liegen im Small String Buffer von libstdc++.
+ */
+static std::size_t owned_string_bytes(const std::string &str)
+{
+	return sizeof(std::string) + (str.size() > 15 ? str.size() + 1 : 0);
+}
+
+/*
+ * Erzeugt persons_count Personen mit addresses_count Adressen aus wenigen
+ * hundert Namen, Städten und Ländern und vergleicht den Speicherbedarf der
+ * Namensfelder mit und ohne StringPool.
+ */
+static void report_interning(std::size_t persons_count, std::size_t addresses_count)
+{
+	static const char *first_names[] = {"Anna", "Bernd", "Christiane", "Dieter", "Elisabeth",
+		"Friedrich", "Gertrud", "Hans-Joachim", "Ingeborg", "Joachim"};
+	static const char *last_names[] = {"Müller", "Schmidt", "Schneider", "Fischer", "Weber",
+		"Meyer", "Wagner", "Becker", "Schulz", "Hoffmann-Schönberger"};
+	static const char *countries[] = {"Deutschland", "Österreich", "Schweiz", "Vereinigtes Königreich"};
+	char buffer[64];
+
+	Timer timer;
+	std::size_t pool_before = StringPool::global().memory_usage();
+	std::size_t owned = 0;
+
+	std::vector<std::unique_ptr<Address>> addresses;
+	addresses.reserve(addresses_count);
+	for(std::size_t i = 0; i < addresses_count; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Musterstraße Nummer %zu", i % 1000);
+		std::string street = buffer;
+		std::snprintf(buffer, sizeof(buffer), "Stadt am Fluss %zu", i % 300);
+		std::string city = buffer;
+		std::string country = countries[i % 4];
+		owned += owned_string_bytes(street) + owned_string_bytes(city) + owned_string_bytes(country);
+		addresses.emplace_back(new Address(street, 1 + i % 200, "10115", city, country));
+	}
+
+	Date birthday = Date::today().add_years(-30);
+	std::vector<std::unique_ptr<Person>> persons;
+	persons.reserve(persons_count);
+	for(std::size_t i = 0; i < persons_count; i++)
+	{
+		std::string first_name = first_names[i % 10];
+		std::snprintf(buffer, sizeof(buffer), "%s%c", last_names[(i / 10) % 10], static_cast<char>('a' + i % 26));
+		std::string last_name = buffer;
+		owned += owned_string_bytes(first_name) + owned_string_bytes(last_name);
+		persons.emplace_back(new Person(first_name, last_name, birthday, *addresses[i % addresses_count]));
+	}
+
+	std::size_t interned = (2 * persons_count + 3 * addresses_count) * sizeof(InternedString)
+		+ StringPool::global().memory_usage() - pool_before;
+	report("interning", persons_count, persons_count + addresses_count, timer,
+		field("owned_bytes", owned) + field("interned_bytes", interned)
+		+ field("saved_bytes", static_cast<double>(owned) - interned));
+}
+
+/*
+ * Lässt threads_count Threads über die RegistrationEngine zufällig ein- und
+ * austragen und prüft danach, dass beide Seiten jeder Beziehung
+ * übereinstimmen.
+ */
+static void stress_registration(std::size_t threads_count, std::size_t ops_per_thread)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	University university("Benchmark University", address);
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	university.hire(teacher, 2000);
+
+	std::vector<std::unique_ptr<Student>> students = make_students(address, 2000);
+	std::vector<Course *> courses;
+	char buffer[32];
+	for(int i = 0; i < 100; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Seminar %03d", i);
+		courses.emplace_back(&university.offer_course(buffer, teacher));
+		// Die Hälfte der Seminare ist beschränkt, damit Wartende nachrücken.
+		if(i % 2 == 0)
+			courses.back()->set_capacity(10);
+	}
+
+	RegistrationEngine engine(university);
+	std::vector<std::thread> threads;
+	Timer timer;
+	for(std::size_t t = 0; t < threads_count; t++)
+	{
+		threads.emplace_back([&, t](){
+			std::mt19937 random(t);
+			for(std::size_t i = 0; i < ops_per_thread; i++)
+			{
+				Student &student = *students[random() % students.size()];
+				Course &course = *courses[random() % courses.size()];
+				switch(random() % 4)
+				{
+				case 0: engine.enroll(student); break;
+				case 1: engine.leave(student, course); break;
+				default: engine.enlist(student, course); break;
+				}
+			}
+		});
+	}
+	for(std::thread &thread : threads)
+		thread.join();
+	report("registration_stress", students.size(), threads_count * ops_per_thread, timer,
+		field("threads", threads_count));
+
+	std::size_t course_side = 0, student_side = 0;
+	bool consistent = true;
+	for(Course *course : courses)
+	{
+		course_side += course->list_students().size() + course->waitlist().size();
+		for(Student *student : course->list_students())
+			consistent = consistent && student->is_enlisted(*course);
+		for(const Waitlist<std::int32_t, Student>::Entry &entry : course->waitlist().entries())
+			consistent = consistent && !entry.item->is_enlisted(*course);
+		consistent = consistent && (course->waitlist().empty() || course->list_students().size() >= course->capacity());
+	}
+	for(auto &student : students)
+	{
+		student_side += student->list_courses().size() + student->list_waitlists().size();
+		for(Course *course : student->list_waitlists())
+			consistent = consistent && course->is_waitlisted(*student);
+	}
+
+	if(!consistent || course_side != student_side)
+	{
+		std::fprintf(stderr, "registration_stress: course rosters and student course sets differ\n");
+		std::exit(1);
+	}
+}
+
+/*
+ * Eine Welt für differential_batches: zwei Universitäten, Seminare an der
+ * ersten, davon einige mit wenigen Plätzen, und Studierende ohne Universität.
+ */
+struct DifferentialWorld {
+	Address address;
+	Teacher teacher;
+	University first;
+	University second;
+	std::vector<Course *> courses;
+	std::vector<std::unique_ptr<Student>> students;
+	std::unordered_map<const Student *, std::size_t> student_index;
+	std::unordered_map<const Course *, std::size_t> course_index;
+
+	DifferentialWorld(): address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland"),
+		teacher("Diff", "Teacher", Date::today().add_years(-50), address),
+		first("Differential University A", address), second("Differential University B", address)
+	{
+		first.hire(teacher, 2000);
+		char buffer[32];
+		for(int i = 0; i < 8; i++)
+		{
+			std::snprintf(buffer, sizeof(buffer), "Differential Seminar %c", 'A' + i);
+			courses.emplace_back(&first.offer_course(buffer, teacher));
+			if(i % 2 == 0)
+				courses.back()->set_capacity(1 + i / 2);
+			course_index[courses.back()] = i;
+		}
+		Date birthday = Date::today().add_years(-20);
+		for(std::size_t i = 0; i < 40; i++)
+		{
+			students.emplace_back(new Student("Diff", "Student", birthday, address));
+			student_index[students.back().get()] = i;
+		}
+	}
+
+	University &university(std::size_t which) { return which == 0 ? first : second; }
+
+	/*
+	 * Beschreibt den gesamten Zustand über die Positionen der Objekte, womit
+	 * sich zwei Welten trotz verschiedener Matrikelnummern vergleichen lassen.
+	 */
+	std::vector<std::int64_t> state()
+	{
+		std::vector<std::int64_t> result;
+		for(std::size_t u = 0; u < 2; u++)
+		{
+			result.push_back(-1);
+			for(Student *student : university(u).list_students())
+				result.push_back(student_index[student]);
+		}
+		for(Course *course : courses)
+		{
+			result.push_back(-2);
+			for(Student *student : course->list_students())
+				result.push_back(student_index[student]);
+			result.push_back(-3);
+			for(const Waitlist<std::int32_t, Student>::Entry &entry : course->waitlist().entries())
+				result.push_back(student_index[entry.item]);
+		}
+		for(auto &student : students)
+		{
+			result.push_back(student->university() == NULL ? -4 : student->university() == &first ? -5 : -6);
+			for(Course *course : student->list_courses())
+				result.push_back(course_index[course]);
+			result.push_back(-7);
+			for(Course *course : student->list_waitlists())
+				result.push_back(course_index[course]);
+		}
+		return result;
+	}
+};
+
+/*
+ * Prüft, dass University::enroll_batch und beide Course::enlist_batch
+ * denselben Endzustand erzeugen wie einzelne enroll und enlist Aufrufe in
+ * derselben Reihenfolge. Je Runde wird eine zufällige Folge aus Batches mit
+ * doppelten Einträgen, Wechseln zwischen den Universitäten, Austragungen und
+ * Änderungen der Plätze einmal über die Batches und einmal über einzelne
+ * Aufrufe ausgeführt und danach die Mitglieder, Seminare und Wartelisten
+ * beider Seiten verglichen. Bei einem Unterschied wird das Programm mit 1
+ * beendet.
+ */
+static void differential_batches(std::size_t rounds)
+{
+	Timer timer;
+	for(std::size_t round = 0; round < rounds; round++)
+	{
+		DifferentialWorld batched, single;
+		std::mt19937 random(round);
+		for(int step = 0; step < 60; step++)
+		{
+			std::size_t kind = random() % 5;
+			std::size_t count = 1 + random() % 12;
+			if(kind == 0)
+			{
+				std::size_t which = random() % 2;
+				std::vector<Student *> list;
+				for(std::size_t i = 0; i < count; i++)
+				{
+					std::size_t s = random() % batched.students.size();
+					list.push_back(batched.students[s].get());
+					single.university(which).enroll(*single.students[s]);
+				}
+				batched.university(which).enroll_batch(list);
+			}
+			else if(kind == 1)
+			{
+				std::size_t c = random() % batched.courses.size();
+				std::vector<Student *> list;
+				for(std::size_t i = 0; i < count; i++)
+				{
+					std::size_t s = random() % batched.students.size();
+					list.push_back(batched.students[s].get());
+					single.courses[c]->enlist(*single.students[s]);
+				}
+				batched.courses[c]->enlist_batch(list);
+			}
+			else if(kind == 2)
+			{
+				std::vector<std::pair<Course *, Student *>> list;
+				for(std::size_t i = 0; i < count; i++)
+				{
+					std::size_t c = random() % batched.courses.size();
+					std::size_t s = random() % batched.students.size();
+					list.emplace_back(batched.courses[c], batched.students[s].get());
+					single.courses[c]->enlist(*single.students[s]);
+				}
+				Course::enlist_batch(list);
+			}
+			else if(kind == 3)
+			{
+				std::size_t c = random() % batched.courses.size();
+				std::size_t s = random() % batched.students.size();
+				batched.courses[c]->leave(*batched.students[s]);
+				single.courses[c]->leave(*single.students[s]);
+			}
+			else
+			{
+				std::size_t c = random() % batched.courses.size();
+				std::size_t capacity = 1 + random() % 6;
+				batched.courses[c]->set_capacity(capacity);
+				single.courses[c]->set_capacity(capacity);
+			}
+		}
+
+		if(batched.state() != single.state())
+		{
+			std::fprintf(stderr, "differential_batches: batch and single calls differ in round %zu\n", round);
+			std::exit(1);
+		}
+	}
+	report("differential_batches", 40, rounds, timer);
+}
+
+/*
+ * Baut eine synthetische Universität mit size Studierenden, size / 10
+ * Lehrkräften und size / 10 Seminaren auf und misst dabei jede Operation des
+ * Modells. Die Darstellungen werden an höchstens 100000 Objekten gemessen.
+ */
+static void bench_model(std::size_t size)
+{
+	std::size_t staff = std::max<std::size_t>(size / 10, 1);
+	std::size_t sample = std::min<std::size_t>(size, 100000);
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+
+	Timer construct_timer;
+	std::vector<std::unique_ptr<Student>> students = make_students(address, size);
+	report("construct_student", size, size, construct_timer);
+
+	std::vector<std::unique_ptr<Teacher>> teachers;
+	teachers.reserve(staff);
+	for(std::size_t i = 0; i < staff; i++)
+		teachers.emplace_back(new Teacher("Bench", "Teacher", birthday, address));
+	std::vector<std::unique_ptr<Person>> persons;
+	persons.reserve(sample);
+	for(std::size_t i = 0; i < sample; i++)
+		persons.emplace_back(new Person("Bench", "Person", birthday, address));
+
+	std::vector<std::string> names(staff);
+	char buffer[32];
+	for(std::size_t i = 0; i < staff; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Seminar %07zu", i);
+		names[i] = buffer;
+	}
+
+	University university("Benchmark University", address);
+
+	Timer enroll_timer;
+	for(auto &student : students)
+		university.enroll(*student);
+	report("enroll", size, size, enroll_timer);
+
+	Timer exmatriculate_timer;
+	for(auto &student : students)
+		university.exmatriculate(*student);
+	report("exmatriculate", size, size, exmatriculate_timer);
+	for(auto &student : students)
+		university.enroll(*student);
+
+	Timer hire_timer;
+	for(auto &teacher : teachers)
+		university.hire(*teacher, 2000);
+	report("hire", size, staff, hire_timer);
+
+	Timer lay_off_timer;
+	for(auto &teacher : teachers)
+		university.lay_off(*teacher);
+	report("lay_off", size, staff, lay_off_timer);
+	for(auto &teacher : teachers)
+		university.hire(*teacher, 2000);
+
+	std::vector<Course *> courses;
+	courses.reserve(staff);
+	Timer offer_timer;
+	for(std::size_t i = 0; i < staff; i++)
+		courses.emplace_back(&university.offer_course(names[i], *teachers[i]));
+	report("offer_course", size, staff, offer_timer);
+
+	Timer assign_timer;
+	for(std::size_t i = 0; i < staff; i++)
+		teachers[(i + 1) % staff]->assign_course(*courses[i]);
+	report("assign_course", size, staff, assign_timer);
+
+	const std::size_t per_student = 3;
+	Timer enlist_timer;
+	for(std::size_t i = 0; i < size; i++)
+		for(std::size_t k = 0; k < per_student; k++)
+			students[i]->enlist(*courses[(i * 7 + k * 131) % staff]);
+	report("enlist", size, size * per_student, enlist_timer);
+
+	Timer leave_timer;
+	for(std::size_t i = 0; i < size; i++)
+		for(std::size_t k = 0; k < per_student; k++)
+			students[i]->leave(*courses[(i * 7 + k * 131) % staff]);
+	report("leave", size, size * per_student, leave_timer);
+	for(std::size_t i = 0; i < size; i++)
+		for(std::size_t k = 0; k < per_student; k++)
+			students[i]->enlist(*courses[(i * 7 + k * 131) % staff]);
+
+	std::size_t bytes = 0;
+	Timer address_timer;
+	for(std::size_t i = 0; i < sample; i++)
+		bytes += address.to_string().size();
+	report("address_to_string", size, sample, address_timer);
+
+	Timer person_timer;
+	for(std::size_t i = 0; i < sample; i++)
+		bytes += persons[i]->to_string().size();
+	report("person_to_string", size, sample, person_timer);
+
+	Timer student_timer;
+	for(std::size_t i = 0; i < sample; i++)
+		bytes += students[i]->to_string().size();
+	report("student_to_string", size, sample, student_timer);
+
+	std::size_t staff_sample = std::min(staff, sample);
+	Timer teacher_timer;
+	for(std::size_t i = 0; i < staff_sample; i++)
+		bytes += teachers[i]->to_string().size();
+	report("teacher_to_string", size, staff_sample, teacher_timer);
+
+	Timer course_timer;
+	for(std::size_t i = 0; i < staff_sample; i++)
+		bytes += courses[i]->to_string().size();
+	report("course_to_string", size, staff_sample, course_timer);
+
+	Timer university_timer;
+	bytes += university.to_string().size();
+	report("university_to_string", size, 1, university_timer, field("bytes", bytes));
+}
+
+/*
+ * Baut eine Universität mit size Studierenden neu auf und vergleicht dies mit
+ * dem Schreiben und Laden eines Snapshots derselben Universität.
+ */
+static void bench_snapshot(std::size_t size)
+{
+	std::size_t staff = std::max<std::size_t>(size / 10, 1);
+	const char *path = "benchmark_snapshot.bin";
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	char buffer[32];
+
+	{
+		Timer rebuild_timer;
+		std::vector<std::unique_ptr<Student>> students = make_students(address, size);
+		std::vector<std::unique_ptr<Teacher>> teachers;
+		for(std::size_t i = 0; i < staff; i++)
+			teachers.emplace_back(new Teacher("Bench", "Teacher", birthday, address));
+		University university("Benchmark University", address);
+		std::vector<Course *> courses;
+		for(std::size_t i = 0; i < staff; i++)
+		{
+			university.hire(*teachers[i], 2000);
+			std::snprintf(buffer, sizeof(buffer), "Seminar %07zu", i);
+			courses.emplace_back(&university.offer_course(buffer, *teachers[i]));
+		}
+		for(std::size_t i = 0; i < size; i++)
+		{
+			students[i]->enroll(university);
+			for(std::size_t k = 0; k < 3; k++)
+				students[i]->enlist(*courses[(i * 7 + k * 131) % staff]);
+		}
+		report("snapshot_rebuild", size, size, rebuild_timer);
+
+		Timer save_timer;
+		Snapshot::save(university, path);
+		report("snapshot_save", size, size, save_timer);
+	}
+
+	Timer load_timer;
+	std::unique_ptr<Snapshot> snapshot = Snapshot::load(path);
+	report("snapshot_load", size, size, load_timer,
+		field("students", snapshot->university().list_students().size()));
+	std::remove(path);
+}
+
+/*
+ * Sucht unter count Studierenden nach Nachnamenspräfix, Stadt und einem
+ * Geburtstagsbereich, einmal durch Durchlaufen von list_students() und einmal
+ * über die Suchindizes.
+ */
+static void bench_person_index(std::size_t count)
+{
+	std::mt19937 random(7);
+	std::vector<std::unique_ptr<Address>> addresses;
+	char buffer[32];
+	for(std::size_t i = 0; i < 1000; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Stadt %zu", i % 200);
+		addresses.emplace_back(new Address("Hauptstrasse", 1 + i, "10115", buffer, "Deutschland"));
+	}
+
+	University university("Benchmark University", *addresses[0]);
+	Date today = Date::today();
+	std::vector<std::unique_ptr<Student>> students;
+	students.reserve(count);
+	for(std::size_t i = 0; i < count; i++)
+	{
+		std::string last_name = "Na";
+		for(int k = 0; k < 4; k++)
+			last_name += static_cast<char>('a' + random() % 26);
+		students.emplace_back(new Student("Bench", last_name,
+			today.add_days(-static_cast<std::int32_t>(365 * 18 + random() % 3650)), *addresses[random() % addresses.size()]));
+		students.back()->enroll(university);
+	}
+
+	Timer build_timer;
+	university.enable_person_indexes();
+	report("index_build", count, count, build_timer);
+
+	Date from = today.add_years(-20);
+	Date to = from.add_days(7);
+	const int queries = 20;
+	std::size_t found = 0;
+
+	Timer scan_timer;
+	for(int q = 0; q < queries; q++)
+	{
+		std::string prefix = "Na";
+		prefix += static_cast<char>('a' + q);
+		prefix += static_cast<char>('a' + q);
+		std::snprintf(buffer, sizeof(buffer), "Stadt %d", q);
+		for(Student *student : university.list_students())
+		{
+			found += student->last_name().compare(0, prefix.size(), prefix) == 0;
+			found += student->place_of_residence().city() == buffer;
+			found += student->birthday() >= from && student->birthday() < to;
+		}
+	}
+	report("index_query_scan", count, queries, scan_timer, field("found", found));
+
+	found = 0;
+	const PersonIndex<Student> &index = *university.student_index();
+	Timer index_timer;
+	for(int q = 0; q < queries; q++)
+	{
+		std::string prefix = "Na";
+		prefix += static_cast<char>('a' + q);
+		prefix += static_cast<char>('a' + q);
+		std::snprintf(buffer, sizeof(buffer), "Stadt %d", q);
+		found += index.by_last_name(prefix).size();
+		found += index.by_city(buffer).size();
+		found += index.by_birthday(from, to).size();
+	}
+	report("index_query", count, queries, index_timer, field("found", found));
+}
+
+/*
+ * Prüft count Personen- und Adressdaten, von denen jeder hundertste ungültig
+ * ist, einmal über die Konstruktoren mit Exceptions und einmal gesammelt.
+ */
+static void bench_validation(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+
+	PackedStrings first_names, last_names, streets, zipcodes, cities, countries;
+	std::vector<Date> birthdays(count, birthday);
+	std::vector<std::int32_t> street_numbers(count, 7);
+	char buffer[32];
+	for(std::size_t i = 0; i < count; i++)
+	{
+		bool invalid = i % 100 == 99;
+		first_names.push_back(invalid ? "Max2" : "Maximiliane");
+		last_names.push_back("Mustermann-Schulze");
+		std::snprintf(buffer, sizeof(buffer), "Hauptstrasse %zu", i % 1000);
+		streets.push_back(buffer);
+		std::snprintf(buffer, sizeof(buffer), invalid ? "1x%03zu" : "1%04zu", i % 1000);
+		zipcodes.push_back(buffer);
+		cities.push_back("Berlin");
+		countries.push_back("Deutschland");
+	}
+
+	std::size_t failures = 0;
+	Timer object_timer;
+	for(std::size_t i = 0; i < count; i++)
+	{
+		try
+		{
+			Person person(std::string(first_names[i]), std::string(last_names[i]), birthdays[i], address);
+			Address residence(std::string(streets[i]), street_numbers[i], std::string(zipcodes[i]),
+				std::string(cities[i]), std::string(countries[i]));
+		}
+		catch(const std::domain_error &)
+		{
+			failures++;
+		}
+	}
+	report("validate_objects", count, count, object_timer, field("invalid", failures));
+
+	Timer batch_timer;
+	ErrorBitmap persons = validate_persons(first_names, last_names, birthdays);
+	ErrorBitmap addresses = validate_addresses(streets, street_numbers, zipcodes, cities, countries);
+	std::size_t batch_failures = 0;
+	for(std::size_t w = 0; w < persons.words().size(); w++)
+		batch_failures += __builtin_popcountll(persons.words()[w] | addresses.words()[w]);
+	report("validate_batch", count, count, batch_timer, field("invalid", batch_failures));
+}
+
+/*
+ * Schreibt count Personen in eine CSV Datei und importiert diese einmal mit
+ * einem und einmal mit allen verfügbaren Threads.
+ */
+static void bench_csv_import(std::size_t count)
+{
+	const char *path = "benchmark_import.csv";
+	std::FILE *file = std::fopen(path, "wb");
+	if(file == NULL)
+		return;
+	std::fputs("kind,first_name,last_name,birthday,street,street_no,zipcode,city,country,loan\n", file);
+	for(std::size_t i = 0; i < count; i++)
+	{
+		if(i % 50 == 0)
+			std::fprintf(file, "teacher,Lehrkraft,Nummer-%c,1970-03-%02zu,Hauptstrasse %zu,%zu,1%04zu,Berlin,Deutschland,%zu\n",
+				static_cast<char>('a' + i % 26), 1 + i % 28, i % 1000, 1 + i % 7, i % 1000, 1000 + i % 5000);
+		else
+			std::fprintf(file, "student,Studentin,Nummer-%c,2001-%02zu-%02zu,Hauptstrasse %zu,%zu,1%04zu,Berlin,Deutschland\n",
+				static_cast<char>('a' + i % 26), 1 + i % 12, 1 + i % 28, i % 1000, 1 + i % 7, i % 1000);
+	}
+	std::fclose(file);
+
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	std::size_t thread_counts[] = {1, std::max<std::size_t>(std::thread::hardware_concurrency(), 2)};
+	for(std::size_t threads : thread_counts)
+	{
+		University university("Benchmark University", address);
+		Timer timer;
+		std::unique_ptr<CsvImport> import = CsvImport::load(path, university, threads);
+		double seconds = elapsed_ns(timer.start) / 1e9;
+		report("csv_import", count, count, timer, field("threads", threads)
+			+ field("records_per_sec", count / seconds)
+			+ field("addresses", import->address_count()));
+	}
+	std::remove(path);
+}
+
+/*
+ * Zufällige Ein- und Austragungen auf wenige stark nachgefragte Seminare mit
+ * begrenzten Plätzen, womit die Wartelisten tausende Einträge haben und bei
+ * jedem Austragen ein Wartender nachrückt.
+ */
+static void bench_waitlist_churn(std::size_t ops)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, 20000);
+	University university("Benchmark University", address);
+
+	std::vector<Course *> courses;
+	char buffer[32];
+	for(int i = 0; i < 4; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Hot Seminar %d", i);
+		courses.emplace_back(&university.offer_course(buffer, teacher));
+		courses.back()->set_capacity(200);
+	}
+
+	std::mt19937 random(42);
+	Timer timer;
+	for(std::size_t i = 0; i < ops; i++)
+	{
+		Student &student = *students[random() % students.size()];
+		Course &course = *courses[random() % courses.size()];
+		if(random() % 2 == 0)
+			student.enlist(course, random() % 8);
+		else
+			student.leave(course);
+	}
+
+	std::size_t waiting = 0;
+	for(Course *course : courses)
+		waiting += course->waitlist().size();
+	report("waitlist_churn", students.size(), ops, timer,
+		field("waiting_per_course", waiting / static_cast<double>(courses.size())));
+}
+
+/*
+ * Ein- und Austragungen einmal ohne Beobachter und einmal mit angemeldetem
+ * ChangeStream, welcher alle 1024 Veränderungen stapelweise geleert wird.
+ */
+static void bench_change_stream(std::size_t ops)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, 10000);
+
+	for(int with_stream = 0; with_stream < 2; with_stream++)
+	{
+		University university("Benchmark University", address);
+		std::unique_ptr<ChangeStream> stream;
+		if(with_stream)
+			stream.reset(new ChangeStream(university, 4096));
+
+		std::vector<Course *> courses;
+		char buffer[32];
+		for(int i = 0; i < 100; i++)
+		{
+			std::snprintf(buffer, sizeof(buffer), "Stream Seminar %d", i);
+			courses.emplace_back(&university.offer_course(buffer, teacher));
+		}
+
+		std::vector<ChangeEvent> events(1024);
+		std::size_t drained = 0;
+		std::mt19937 random(19);
+		Timer timer;
+		for(std::size_t i = 0; i < ops; i++)
+		{
+			Student &student = *students[random() % students.size()];
+			Course &course = *courses[random() % courses.size()];
+			if(random() % 2 == 0)
+				student.enlist(course);
+			else
+				student.leave(course);
+			if(stream && i % 1024 == 1023)
+				drained += stream->drain(events.data(), events.size());
+		}
+		if(stream)
+		{
+			drained += stream->drain(events.data(), events.size());
+			report("change_stream_enlist", students.size(), ops, timer,
+				field("drained", drained) + field("dropped", stream->dropped()));
+		}
+		else
+			report("change_stream_baseline", students.size(), ops, timer);
+	}
+}
+
+/*
+ * Verteilt count Studierende auf 8 Universitäten einer Föderation und lässt
+ * sie mit 1 und mit allen Kernen zufällig wechseln. Danach wird die Abfrage
+ * über alle Universitäten mit einem und mit allen Kernen gemessen.
+ */
+static void bench_federation(std::size_t count, std::size_t ops)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	std::vector<std::unique_ptr<Student>> students = make_students(address, count);
+	std::vector<std::unique_ptr<University>> universities;
+	Federation federation;
+	char buffer[32];
+	for(int i = 0; i < 8; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Federated University %c", 'A' + i);
+		universities.emplace_back(new University(buffer, address));
+		federation.add_shard(*universities.back());
+	}
+	for(std::size_t i = 0; i < students.size(); i++)
+		federation.enroll(*students[i], i % federation.shards());
+
+	std::size_t cores = std::max(2u, std::thread::hardware_concurrency());
+	for(std::size_t threads : {std::size_t(1), cores})
+	{
+		std::vector<std::thread> workers;
+		Timer timer;
+		for(std::size_t t = 0; t < threads; t++)
+		{
+			workers.emplace_back([&, t](){
+				std::mt19937 random(21 + t);
+				for(std::size_t i = 0; i < ops / threads; i++)
+					federation.enroll(*students[random() % students.size()], random() % federation.shards());
+			});
+		}
+		for(std::thread &worker : workers)
+			worker.join();
+		report(threads == 1 ? "federation_transfer_1" : "federation_transfer_all", count, ops, timer,
+			field("threads", threads));
+	}
+
+	for(std::size_t threads : {std::size_t(1), cores})
+	{
+		const int rounds = 5;
+		std::size_t found = 0;
+		Timer timer;
+		for(int r = 0; r < rounds; r++)
+			found += federation.students_in_city("Berlin", threads).size();
+		report(threads == 1 ? "federation_query_1" : "federation_query_all", count, rounds, timer,
+			field("threads", threads) + field("found", found / rounds));
+	}
+}
+
+/*
+ * Ein Thread schreibt zufällig in 100 Seminare ein und aus, einmal allein und
+ * einmal mit angemeldeter VersionedView, während ein zweiter Thread laufend
+ * eine Version abholt und daraus den vollständigen Bericht der Universität
+ * und aller Seminare erzeugt.
+ */
+static void bench_versioned_view(std::size_t count, std::size_t ops)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, count);
+
+	for(int with_view = 0; with_view < 2; with_view++)
+	{
+		University university("Benchmark University", address);
+		std::vector<Course *> courses;
+		char buffer[32];
+		for(int i = 0; i < 100; i++)
+		{
+			std::snprintf(buffer, sizeof(buffer), "Versioned Seminar %d", i);
+			courses.emplace_back(&university.offer_course(buffer, teacher));
+		}
+		for(std::unique_ptr<Student> &student : students)
+			student->enroll(university);
+
+		std::unique_ptr<VersionedView> view;
+		if(with_view)
+			view.reset(new VersionedView(university));
+
+		std::atomic<bool> writing(true);
+		std::atomic<bool> reading(false);
+		std::size_t reports = 0, report_bytes = 0;
+		std::unique_ptr<ThreadMeasurement> reader_measurement;
+		std::thread reader;
+		if(view)
+		{
+			reader = std::thread([&](){
+				Timer reader_timer;
+				reading = true;
+				std::string report;
+				do
+				{
+					std::shared_ptr<const UniversityVersion> version = view->snapshot();
+					report.clear();
+					version->append_to(report);
+					for(const std::shared_ptr<const VersionedCourse> &course : version->courses())
+						course->append_to(report);
+					report_bytes += report.size();
+					reports++;
+				} while(writing.load(std::memory_order_relaxed));
+				reader_measurement.reset(new ThreadMeasurement(reader_timer));
+			});
+			while(!reading)
+				std::this_thread::yield();
+		}
+
+		// Beide Threads zählen nur ihre eigenen Speicheranforderungen, sonst
+		// landen die Berichte des Lesers in den Kosten des Schreibers.
+		std::mt19937 random(22);
+		Timer timer;
+		for(std::size_t i = 0; i < ops; i++)
+		{
+			Student &student = *students[random() % students.size()];
+			Course &course = *courses[random() % courses.size()];
+			if(random() % 2 == 0)
+				student.enlist(course);
+			else
+				student.leave(course);
+		}
+		ThreadMeasurement writer_measurement(timer);
+		writing = false;
+		report(with_view ? "versioned_view_writer" : "versioned_view_writer_baseline", count, ops, writer_measurement);
+		if(reader.joinable())
+		{
+			reader.join();
+			report("versioned_view_reader", count, reports, *reader_measurement,
+				field("report_kb", report_bytes / 1024.0 / std::max<std::size_t>(reports, 1)));
+		}
+	}
+}
+
+/*
+ * Schreibt count Studierende zufällig in 1000 Seminare ein, einmal ohne und
+ * einmal mit angemeldeter EnrollmentStatistics. Danach werden die Kennzahlen
+ * einmal über alle Seminare und Studierenden und einmal aus der Statistik
+ * bestimmt.
+ */
+static void bench_statistics(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, count);
+
+	for(int with_statistics = 0; with_statistics < 2; with_statistics++)
+	{
+		University university("Benchmark University", address);
+		std::unique_ptr<EnrollmentStatistics> statistics;
+		if(with_statistics)
+			statistics.reset(new EnrollmentStatistics(university));
+
+		std::vector<Course *> courses;
+		char buffer[32];
+		for(int i = 0; i < 1000; i++)
+		{
+			std::snprintf(buffer, sizeof(buffer), "Statistics Seminar %d", i);
+			courses.emplace_back(&university.offer_course(buffer, teacher));
+		}
+
+		std::mt19937 random(18);
+		Timer timer;
+		for(std::unique_ptr<Student> &student : students)
+		{
+			student->enroll(university);
+			for(int k = 0; k < 4; k++)
+				student->enlist(*courses[random() % courses.size()]);
+		}
+		report(with_statistics ? "statistics_enlist_tracked" : "statistics_enlist_untracked", count, count * 5, timer);
+
+		if(!with_statistics)
+			continue;
+
+		const int rounds = 10;
+		std::size_t checksum = 0;
+		Timer walk_timer;
+		for(int r = 0; r < rounds; r++)
+		{
+			std::size_t enlistments = 0, empty = 0, largest = 0;
+			std::vector<std::size_t> per_student;
+			for(Course *course : university.list_courses())
+			{
+				std::size_t size = course->list_students().size();
+				enlistments += size;
+				empty += size == 0;
+				largest = std::max(largest, size);
+			}
+			for(Student *student : university.list_students())
+			{
+				std::size_t size = student->list_courses().size();
+				if(size >= per_student.size())
+					per_student.resize(size + 1, 0);
+				per_student[size]++;
+			}
+			checksum += enlistments + empty + largest + per_student.size();
+		}
+		report("statistics_walk", count, rounds, walk_timer, field("checksum", checksum));
+
+		checksum = 0;
+		Timer figures_timer;
+		for(int r = 0; r < rounds; r++)
+		{
+			EnrollmentFigures figures = statistics->figures();
+			checksum += figures.enlistments + figures.empty_courses + figures.largest_course
+				+ statistics->courses_per_student().size();
+		}
+		report("statistics_figures", count, rounds, figures_timer, field("checksum", checksum));
+
+		for(std::unique_ptr<Student> &student : students)
+			student->exmatriculate();
+		statistics.reset();
+	}
+}
+
+/*
+ * Stellt count Lehrkräfte mit zufälligen Gehältern an und ändert danach
+ * zufällige Gehälter. Die Kennzahlen werden einmal über alle Lehrkraftobjekte,
+ * einmal über die Gehaltsspalte und einmal aus der laufenden Abrechnung
+ * bestimmt.
+ */
+static void bench_payroll(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	std::vector<std::unique_ptr<Teacher>> teachers;
+	teachers.reserve(count);
+	for(std::size_t i = 0; i < count; i++)
+		teachers.emplace_back(new Teacher("Bench", "Teacher", birthday, address));
+
+	University university("Benchmark University", address);
+	std::mt19937 random(17);
+	Timer hire_timer;
+	for(std::unique_ptr<Teacher> &teacher : teachers)
+		teacher->hire(university, 1000 + random() % 9000);
+	report("payroll_hire", count, count, hire_timer);
+
+	Timer change_timer;
+	for(std::size_t i = 0; i < count; i++)
+		teachers[random() % count]->change_loan(1000 + random() % 9000);
+	report("payroll_change_loan", count, count, change_timer);
+
+	const int rounds = 20;
+	std::int64_t total = 0;
+	Timer scan_timer;
+	for(int r = 0; r < rounds; r++)
+	{
+		for(Teacher *teacher : university.list_teachers())
+			total += teacher->loan();
+	}
+	report("payroll_total_scan", count, rounds, scan_timer, field("total", total / rounds));
+
+	total = 0;
+	const Payroll &payroll = university.payroll();
+	Timer column_timer;
+	for(int r = 0; r < rounds; r++)
+		total += summarize_loans(payroll.loans().data(), payroll.size()).total;
+	report("payroll_summarize_column", count, rounds, column_timer, field("total", total / rounds));
+
+	total = 0;
+	bool verified = payroll.verify();
+	Timer summary_timer;
+	for(int r = 0; r < rounds; r++)
+		total += payroll.summary().total;
+	report("payroll_summary", count, rounds, summary_timer,
+		field("total", total / rounds) + field("verified", verified));
+}
+
+/*
+ * Jeder Studierende versucht sich in zehn zufällige Seminare mit je zwei
+ * Zeiträumen einzuschreiben, Überschneidungen werden dabei abgelehnt.
+ * Anschließend erhalten einige Seminare einen weiteren Zeitraum und die
+ * Überschneidungen der ganzen Universität werden mit einem und mit mehreren
+ * Threads gesucht.
+ */
+static void bench_schedule(std::size_t count)
+{
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, count);
+	University university("Benchmark University", address);
+	university.hire(teacher, 5000);
+	for(std::unique_ptr<Student> &student : students)
+		student->enroll(university);
+
+	std::mt19937 random(16);
+	std::vector<Course *> courses;
+	char buffer[32];
+	for(int i = 0; i < 400; i++)
+	{
+		std::snprintf(buffer, sizeof(buffer), "Timetable Seminar %d", i);
+		courses.emplace_back(&university.offer_course(buffer, teacher));
+		courses.back()->resign_teacher();
+		int day = random() % 4;
+		int begin = 480 + random() % 20 * 30;
+		courses.back()->add_slot(TimeSlot::weekly(day, begin, begin + 90));
+		courses.back()->add_slot(TimeSlot::weekly(day + 1 + random() % (4 - day), begin, begin + 90));
+	}
+
+	std::size_t rejected = 0;
+	Timer enlist_timer;
+	for(std::unique_ptr<Student> &student : students)
+	{
+		for(int k = 0; k < 10; k++)
+		{
+			try
+			{
+				student->enlist(*courses[random() % courses.size()]);
+			}
+			catch(const std::domain_error &)
+			{
+				rejected++;
+			}
+		}
+	}
+	report("schedule_enlist", count, count * 10, enlist_timer, field("rejected", rejected));
+
+	for(std::size_t i = 0; i < courses.size(); i += 20)
+		courses[i]->add_slot(TimeSlot::weekly(5, 600, 690));
+	for(std::size_t i = 10; i < courses.size(); i += 20)
+		courses[i]->add_slot(TimeSlot::weekly(5, 660, 720));
+
+	std::size_t threads_counts[] = {1, 4};
+	for(std::size_t threads : threads_counts)
+	{
+		Timer timer;
+		std::size_t conflicts = university.find_conflicts(threads).size();
+		report("schedule_find_conflicts", count, count, timer, field("threads", threads) + field("conflicts", conflicts));
+	}
+}
+
+/*
+ * Schreibt ops Ein- und Austragungen in ein Journal, einmal mit fdatasync je
+ * Veränderung und einmal gruppenweise, und spielt das Journal anschließend
+ * auf eine leere Universität ein.
+ */
+static void bench_journal(std::size_t ops)
+{
+	const char *path = "benchmark_journal.bin";
+	Address address("Benchmarkstrasse", 1, "10115", "Berlin", "Deutschland");
+	Date birthday = Date::today().add_years(-40);
+	std::vector<std::unique_ptr<Student>> students = make_students(address, 1000);
+	Teacher teacher("Bench", "Teacher", birthday, address);
+	std::unordered_map<std::int32_t, Student *> by_number;
+	for(std::unique_ptr<Student> &student : students)
+		by_number.emplace(student->student_number(), student.get());
+
+	std::size_t group_sizes[] = {1, 64, 1024};
+	for(std::size_t group_size : group_sizes)
+	{
+		std::remove(path);
+		// Ohne Gruppierung kostet jede Veränderung eine Plattensynchronisation.
+		std::size_t count = group_size == 1 ? std::min<std::size_t>(ops, 2000) : ops;
+		{
+			University university("Benchmark University", address);
+			Journal journal(university, path, group_size);
+			Course &course = university.offer_course("Journal Seminar", teacher);
+
+			Timer timer;
+			for(std::size_t i = 0; i < count; i++)
+			{
+				Student &student = *students[i % students.size()];
+				if(i / students.size() % 2 == 0)
+					student.enlist(course);
+				else
+					student.leave(course);
+			}
+			journal.flush();
+			double seconds = elapsed_ns(timer.start) / 1e9;
+			report("journal_append", count, count, timer, field("group_size", group_size) + field("ops_per_sec", count / seconds));
+		}
+	}
+
+	University university("Benchmark University", address);
+	Timer timer;
+	std::size_t replayed = Journal::replay(path, university,
+		[&](std::int32_t number){ auto it = by_number.find(number); return it != by_number.end() ? it->second : NULL; },
+		[&](std::int32_t number){ return number == teacher.staff_number() ? &teacher : NULL; });
+	report("journal_replay", replayed, replayed, timer);
+	std::remove(path);
+}
+
+int main(int argc, char **argv)
+{
+	std::size_t max_size = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 1000000;
+	std::size_t sizes[] = {1000, 10000, 100000, 1000000};
+
+	for(std::size_t size : sizes)
+	{
+		if(size > max_size)
+			break;
+		bench_model(size);
+		bench_membership(size, std::min<std::size_t>(size, 1000));
+	}
+
+	std::size_t large = std::min<std::size_t>(max_size, 1000000);
+	bench_render(std::min<std::size_t>(large, 50000), 5);
+	bench_formatting(std::min<std::size_t>(large, 200000));
+	bench_birth_years(large);
+	bench_age_queries(large);
+	bench_snapshot(large);
+	bench_person_index(large);
+	bench_validation(large);
+	bench_csv_import(large);
+	bench_waitlist_churn(large);
+	bench_schedule(large);
+	bench_payroll(large);
+	bench_statistics(large);
+	bench_change_stream(large);
+	bench_federation(large, large);
+	bench_versioned_view(std::min<std::size_t>(large, 100000), large);
+	bench_journal(large);
+	report_interning(large, std::max<std::size_t>(large / 10, 1));
+	stress_registration(std::max(2u, std::thread::hardware_concurrency()), 200000);
+	differential_batches(200);
+
+	if(Instrumentation::enabled())
+	{
+		std::string report;
+		Instrumentation::append_json(report);
+		std::puts(report.c_str());
+	}
+}
@@ -0,0 +1,158 @@
+#include "change_stream.h"
+#include "persons.h"
+#include "university.h"
+
+static std::uint64_t ring_size(std::size_t capacity)
+{
+	std::uint64_t size = 2;
+	while(size < capacity)
+		size <<= 1;
+	return size;
+}
+
+ChangeStream::ChangeStream(University &university, std::size_t capacity):
+	m_university(university), m_cells(new Cell[ring_size(capacity)]), m_mask(ring_size(capacity) - 1),
+	m_write(0), m_read(0), m_dropped(0)
+{
+	for(std::uint64_t i = 0; i <= m_mask; i++)
+		m_cells[i].position.store(i, std::memory_order_relaxed);
+	m_university.add_listener(*this);
+}
+
+ChangeStream::~ChangeStream()
+{
+	m_university.remove_listener(*this);
+}
+
+/*
+ * Ein Platz ist frei zum Schreiben wenn seine Sequenznummer der
+ * Schreibposition entspricht und enthält ein Ereignis wenn sie um eins größer
+ * ist. Nach dem Lesen wird sie um die Größe des Rings weitergezählt, womit
+ * der Platz in der nächsten Runde wieder frei ist.
+ */
+void ChangeStream::publish(ChangeEvent::Type type, std::uint32_t course, std::int32_t person, std::int64_t value)
+{
+	std::uint64_t position = m_write.load(std::memory_order_relaxed);
+	Cell *cell;
+	for(;;)
+	{
+		cell = &m_cells[position & m_mask];
+		std::uint64_t sequence = cell->position.load(std::memory_order_acquire);
+		std::int64_t distance = static_cast<std::int64_t>(sequence - position);
+		if(distance == 0)
+		{
+			if(m_write.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if(distance < 0)
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+			position = m_write.load(std::memory_order_relaxed);
+	}
+
+	cell->event.sequence = position;
+	cell->event.value = value;
+	cell->event.course = course;
+	cell->event.person = person;
+	cell->event.type = type;
+	cell->position.store(position + 1, std::memory_order_release);
+}
+
+std::size_t ChangeStream::drain(ChangeEvent *events, std::size_t max)
+{
+	std::size_t count = 0;
+	std::uint64_t position = m_read.load(std::memory_order_relaxed);
+	while(count < max)
+	{
+		Cell &cell = m_cells[position & m_mask];
+		std::uint64_t sequence = cell.position.load(std::memory_order_acquire);
+		std::int64_t distance = static_cast<std::int64_t>(sequence - (position + 1));
+		if(distance == 0)
+		{
+			if(m_read.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				events[count++] = cell.event;
+				cell.position.store(position + m_mask + 1, std::memory_order_release);
+				position++;
+			}
+		}
+		else if(distance < 0)
+			break;
+		else
+			position = m_read.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+void ChangeStream::enrolled(const Student &student)
+{
+	publish(ChangeEvent::Type::Enroll, ChangeEvent::s_no_course, student.student_number());
+}
+
+void ChangeStream::exmatriculated(const Student &student)
+{
+	publish(ChangeEvent::Type::Exmatriculate, ChangeEvent::s_no_course, student.student_number());
+}
+
+void ChangeStream::hired(const Teacher &teacher, std::int32_t loan)
+{
+	publish(ChangeEvent::Type::Hire, ChangeEvent::s_no_course, teacher.staff_number(), loan);
+}
+
+void ChangeStream::laid_off(const Teacher &teacher)
+{
+	publish(ChangeEvent::Type::LayOff, ChangeEvent::s_no_course, teacher.staff_number());
+}
+
+void ChangeStream::loan_changed(const Teacher &teacher, std::int32_t loan)
+{
+	publish(ChangeEvent::Type::LoanChange, ChangeEvent::s_no_course, teacher.staff_number(), loan);
+}
+
+void ChangeStream::course_offered(const Course &course)
+{
+	publish(ChangeEvent::Type::OfferCourse, course.id(), 0);
+}
+
+void ChangeStream::enlisted(const Course &course, const Student &student)
+{
+	publish(ChangeEvent::Type::Enlist, course.id(), student.student_number());
+}
+
+void ChangeStream::left(const Course &course, const Student &student)
+{
+	publish(ChangeEvent::Type::Leave, course.id(), student.student_number());
+}
+
+void ChangeStream::waitlisted(const Course &course, const Student &student, std::int64_t priority)
+{
+	publish(ChangeEvent::Type::Waitlist, course.id(), student.student_number(), priority);
+}
+
+void ChangeStream::left_waitlist(const Course &course, const Student &student)
+{
+	publish(ChangeEvent::Type::LeaveWaitlist, course.id(), student.student_number());
+}
+
+void ChangeStream::capacity_changed(const Course &course, std::size_t capacity)
+{
+	publish(ChangeEvent::Type::Capacity, course.id(), 0, static_cast<std::int64_t>(capacity));
+}
+
+void ChangeStream::teacher_assigned(const Course &course, const Teacher &teacher)
+{
+	publish(ChangeEvent::Type::AssignTeacher, course.id(), teacher.staff_number());
+}
+
+void ChangeStream::teacher_resigned(const Course &course, const Teacher &teacher)
+{
+	publish(ChangeEvent::Type::ResignTeacher, course.id(), teacher.staff_number());
+}
+
+void ChangeStream::slot_added(const Course &course, const TimeSlot &slot)
+{
+	publish(ChangeEvent::Type::Slot, course.id(), 0, slot.begin | static_cast<std::int64_t>(slot.end) << 16);
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include "listener.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class University;
+
+/**
+ * @brief Kompakte Beschreibung einer Veränderung an einer Universität.
+ * Personen werden über ihre Matrikel- bzw. Personalnummer referenziert,
+ * Seminare über ihre Seminarnummer.
+ */
+struct ChangeEvent {
+  enum class Type : std::uint8_t {
+    Enroll = 1,
+    Exmatriculate,
+    Hire,
+    LayOff,
+    LoanChange,
+    OfferCourse,
+    Enlist,
+    Leave,
+    Waitlist,
+    LeaveWaitlist,
+    Capacity,
+    AssignTeacher,
+    ResignTeacher,
+    Slot
+  };
+
+  /**
+   * @brief Fortlaufende Nummer des Ereignisses im Strom, drain() liefert die
+   * Ereignisse lückenlos in dieser Reihenfolge.
+   */
+  std::uint64_t sequence;
+
+  /**
+   * @brief Gehalt, Priorität auf der Warteliste, Kapazität oder Zeitraum
+   * (Beginn in den unteren, Ende in den oberen 16 Bit), sonst 0.
+   */
+  std::int64_t value;
+
+  /**
+   * @brief Seminarnummer bei Veränderungen ohne Seminar. Die Seminarnummern
+   * beginnen bei 0, diese kann deshalb nicht verwendet werden.
+   */
+  static constexpr std::uint32_t s_no_course = 0xffffffff;
+
+  /**
+   * @brief Seminarnummer oder s_no_course bei Veränderungen ohne Seminar.
+   */
+  std::uint32_t course;
+
+  /**
+   * @brief Matrikel- oder Personalnummer oder 0.
+   */
+  std::int32_t person;
+
+  Type type;
+};
+
+/**
+ * @brief Strom aller Veränderungen einer Universität für nachgelagerte
+ * Systeme. Der Strom meldet sich als MutationListener an und legt jede
+ * Veränderung als ChangeEvent in einem Ringpuffer fester Größe ab, aus
+ * welchem Verbraucher die Ereignisse stapelweise mit drain() entnehmen.
+ *
+ * Der Ringpuffer kommt ohne Sperren aus: jeder Platz trägt eine
+ * Sequenznummer, Erzeuger und Verbraucher reservieren ihre Plätze über ein
+ * compare-and-swap auf die Schreib- bzw. Leseposition. Es dürfen beliebig
+ * viele Threads gleichzeitig Veränderungen erzeugen (z.B. über die
+ * RegistrationEngine) und beliebig viele Verbraucher entnehmen.
+ *
+ * Überlauf: Ist der Puffer voll, wird das neue Ereignis verworfen und
+ * dropped() erhöht, der verändernde Thread wartet nie auf Verbraucher.
+ * Verbraucher erkennen verlorene Ereignisse an einem gestiegenen dropped()
+ * und können sich z.B. über einen Snapshot neu synchronisieren.
+ *
+ * Der Strom muss vor der Universität zerstört werden.
+ */
+class ChangeStream : public MutationListener {
+private:
+  struct Cell {
+    std::atomic<std::uint64_t> position;
+    ChangeEvent event;
+  };
+
+  University &m_university;
+  std::unique_ptr<Cell[]> m_cells;
+  const std::uint64_t m_mask;
+  alignas(64) std::atomic<std::uint64_t> m_write;
+  alignas(64) std::atomic<std::uint64_t> m_read;
+  std::atomic<std::uint64_t> m_dropped;
+
+  void publish(ChangeEvent::Type type, std::uint32_t course, std::int32_t person, std::int64_t value = 0);
+
+public:
+  /**
+   * @brief Legt den Ringpuffer an und meldet den Strom an der Universität an.
+   *
+   * @param university Universität deren Veränderungen veröffentlicht werden.
+   * @param capacity Anzahl der Plätze, wird auf die nächste Zweierpotenz
+   * aufgerundet.
+   */
+  ChangeStream(University &university, std::size_t capacity = 1 << 16);
+
+  ChangeStream(const ChangeStream &) = delete;
+  ChangeStream &operator=(const ChangeStream &) = delete;
+
+  /**
+   * @brief Meldet den Strom von der Universität ab.
+   */
+  virtual ~ChangeStream();
+
+  /**
+   * @brief Entnimmt höchstens max Ereignisse in der Reihenfolge ihrer
+   * Ablage, ohne zu warten.
+   *
+   * @param events Puffer für mindestens max Ereignisse.
+   * @return Die Anzahl der entnommenen Ereignisse.
+   */
+  std::size_t drain(ChangeEvent *events, std::size_t max);
+
+  /**
+   * @return Die Anzahl der wegen Überlauf verworfenen Ereignisse.
+   */
+  std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+  /**
+   * @return Die Anzahl der Plätze im Ringpuffer.
+   */
+  std::size_t capacity() const { return m_mask + 1; }
+
+  void enrolled(const Student &student) override;
+  void exmatriculated(const Student &student) override;
+  void hired(const Teacher &teacher, std::int32_t loan) override;
+  void laid_off(const Teacher &teacher) override;
+  void loan_changed(const Teacher &teacher, std::int32_t loan) override;
+  void course_offered(const Course &course) override;
+  void enlisted(const Course &course, const Student &student) override;
+  void left(const Course &course, const Student &student) override;
+  void waitlisted(const Course &course, const Student &student, std::int64_t priority) override;
+  void left_waitlist(const Course &course, const Student &student) override;
+  void capacity_changed(const Course &course, std::size_t capacity) override;
+  void teacher_assigned(const Course &course, const Teacher &teacher) override;
+  void teacher_resigned(const Course &course, const Teacher &teacher) override;
+  void slot_added(const Course &course, const TimeSlot &slot) override;
+};
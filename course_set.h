@@ -0,0 +1,67 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class Course;
+
+/**
+ * @brief Kompakte Menge von Seminaren einer Person. Die Seminare werden über
+ * ihre fortlaufende Seminarnummer (Course::id) identifiziert und nach dieser
+ * sortiert in zwei parallelen Vektoren abgelegt. Eine Person belegt nur wenige
+ * Seminare, die Mitgliedschaftsprüfung ist damit eine binäre Suche über ein
+ * paar Ganzzahlen ohne Speicheranforderung und ohne Namensvergleiche.
+ */
+class CourseSet {
+private:
+  std::vector<std::uint32_t> m_ids;
+  std::vector<Course *> m_courses;
+
+public:
+  /**
+   * @return true Wenn das Seminar mit der Nummer in der Menge enthalten ist.
+   */
+  bool contains(std::uint32_t id) const {
+    return std::binary_search(m_ids.begin(), m_ids.end(), id);
+  }
+
+  /**
+   * @brief Fügt das Seminar ein, falls es noch nicht enthalten ist.
+   *
+   * @return true Wenn das Seminar eingefügt wurde.
+   */
+  bool insert(std::uint32_t id, Course *course) {
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it != m_ids.end() && *it == id)
+      return false;
+    auto pos = it - m_ids.begin();
+    m_ids.insert(it, id);
+    m_courses.insert(m_courses.begin() + pos, course);
+    return true;
+  }
+
+  /**
+   * @brief Entfernt das Seminar, falls es enthalten ist.
+   *
+   * @return true Wenn das Seminar entfernt wurde.
+   */
+  bool erase(std::uint32_t id) {
+    auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+    if (it == m_ids.end() || *it != id)
+      return false;
+    auto pos = it - m_ids.begin();
+    m_ids.erase(it);
+    m_courses.erase(m_courses.begin() + pos);
+    return true;
+  }
+
+  std::size_t size() const { return m_ids.size(); }
+
+  bool empty() const { return m_ids.empty(); }
+
+  /**
+   * @return std::vector<Course*>& Alle Seminare, sortiert nach Seminarnummer.
+   */
+  std::vector<Course *> &items() { return m_courses; }
+  const std::vector<Course *> &items() const { return m_courses; }
+};
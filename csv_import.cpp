@@ -0,0 +1,417 @@
+#include "csv_import.h"
+#include "validation.h"
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+static const std::size_t s_import_fields = 10;
+
+enum class ImportKind : std::uint8_t {
+	Student,
+	Teacher
+};
+
+/*
+ * Zerlegter und geprüfter Block der Datei. Auch ungültige Zeilen bekommen
+ * einen Eintrag in allen Spalten, damit die Indizes zu errors passen. Die
+ * Zeilennummern sind relativ zum Anfang des Blocks.
+ */
+struct ImportChunk {
+	std::size_t sequence;
+	std::string text;
+	std::size_t line_count;
+	std::vector<std::size_t> lines;
+	std::vector<ImportKind> kinds;
+	PackedStrings first_names;
+	PackedStrings last_names;
+	PackedStrings streets;
+	PackedStrings zipcodes;
+	PackedStrings cities;
+	PackedStrings countries;
+	PackedStrings address_keys;
+	std::vector<Date> birthdays;
+	std::vector<std::int32_t> street_numbers;
+	std::vector<std::int32_t> loans;
+	ErrorBitmap errors;
+
+	ImportChunk(): sequence(0), line_count(0), errors(0){}
+};
+
+/*
+ * Zerlegt eine Zeile an den Kommas. Felder in Anführungszeichen werden ohne
+ * diese in scratch abgelegt, scratch wächst dabei nie über die Zeilenlänge
+ * hinaus und wird deshalb nicht verschoben.
+ *
+ * @return Die Anzahl der Felder, auch wenn diese max übersteigt.
+ */
+static std::size_t split_fields(std::string_view line, std::string_view *fields, std::size_t max, std::string &scratch)
+{
+	scratch.clear();
+	scratch.reserve(line.size());
+
+	std::size_t count = 0;
+	std::size_t i = 0;
+	for(;;)
+	{
+		std::string_view field;
+		if(i < line.size() && line[i] == '"')
+		{
+			std::size_t begin = scratch.size();
+			for(i++; i < line.size(); i++)
+			{
+				if(line[i] == '"')
+				{
+					if(i + 1 < line.size() && line[i + 1] == '"')
+						i++;
+					else
+						break;
+				}
+				scratch += line[i];
+			}
+			field = std::string_view(scratch.data() + begin, scratch.size() - begin);
+			while(i < line.size() && line[i] != ',')
+				i++;
+		}
+		else
+		{
+			std::size_t end = line.find(',', i);
+			if(end == std::string_view::npos)
+				end = line.size();
+			field = line.substr(i, end - i);
+			i = end;
+		}
+
+		if(count < max)
+			fields[count] = field;
+		count++;
+		if(i >= line.size())
+			return count;
+		i++;
+	}
+}
+
+static bool parse_number(std::string_view text, std::int32_t &value)
+{
+	std::from_chars_result result = std::from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+/*
+ * Liest ein Datum der Form JJJJ-MM-TT.
+ */
+static bool parse_date(std::string_view text, Date &date)
+{
+	std::int32_t year, month, day;
+	if(text.size() != 10 || text[4] != '-' || text[7] != '-' || !parse_number(text.substr(0, 4), year)
+		|| !parse_number(text.substr(5, 2), month) || !parse_number(text.substr(8, 2), day)
+		|| !Date::valid(year, month, day))
+		return false;
+
+	date = Date::from_civil(year, month, day);
+	return true;
+}
+
+/*
+ * Zerlegt alle Zeilen des Blocks in die Spalten und prüft diese.
+ */
+static void parse_chunk(ImportChunk &chunk)
+{
+	std::string_view text(chunk.text);
+	std::string scratch;
+	std::string key;
+	std::string_view fields[s_import_fields];
+	std::vector<std::size_t> malformed;
+
+	std::size_t expected = text.size() / 64;
+	chunk.first_names.reserve(expected, expected * 8);
+	chunk.last_names.reserve(expected, expected * 8);
+	chunk.streets.reserve(expected, expected * 16);
+	chunk.zipcodes.reserve(expected, expected * 5);
+	chunk.cities.reserve(expected, expected * 8);
+	chunk.countries.reserve(expected, expected * 8);
+	chunk.address_keys.reserve(expected, expected * 48);
+
+	std::size_t line = 0;
+	std::size_t begin = 0;
+	while(begin < text.size())
+	{
+		std::size_t end = text.find('\n', begin);
+		if(end == std::string_view::npos)
+			end = text.size();
+		std::string_view row = text.substr(begin, end - begin);
+		begin = end + 1;
+		line++;
+
+		if(!row.empty() && row.back() == '\r')
+			row.remove_suffix(1);
+		if(row.empty())
+			continue;
+		if(chunk.sequence == 0 && line == 1 && (row.substr(0, 4) == "art," || row.substr(0, 5) == "kind,"))
+			continue;
+
+		std::size_t count = split_fields(row, fields, s_import_fields, scratch);
+		Date birthday;
+		std::int32_t street_no = 0;
+		std::int32_t loan = 0;
+		bool student = fields[0] == "student";
+		bool valid = (count == s_import_fields || (student && count == s_import_fields - 1))
+			&& (student || fields[0] == "teacher")
+			&& parse_date(fields[3], birthday) && parse_number(fields[5], street_no)
+			&& (student || parse_number(fields[9], loan));
+
+		if(!valid)
+		{
+			malformed.emplace_back(chunk.lines.size());
+			for(std::size_t i = std::min(count, s_import_fields); i < s_import_fields; i++)
+				fields[i] = std::string_view();
+		}
+		else if(!student && loan < 1000)
+			malformed.emplace_back(chunk.lines.size());
+
+		key.assign(fields[4]);
+		key += '\x1f';
+		key += fields[5];
+		key += '\x1f';
+		key += fields[6];
+		key += '\x1f';
+		key += fields[7];
+		key += '\x1f';
+		key += fields[8];
+
+		chunk.lines.emplace_back(line);
+		chunk.kinds.emplace_back(student ? ImportKind::Student : ImportKind::Teacher);
+		chunk.first_names.push_back(fields[1]);
+		chunk.last_names.push_back(fields[2]);
+		chunk.birthdays.emplace_back(birthday);
+		chunk.streets.push_back(fields[4]);
+		chunk.street_numbers.emplace_back(street_no);
+		chunk.zipcodes.push_back(fields[6]);
+		chunk.cities.push_back(fields[7]);
+		chunk.countries.push_back(fields[8]);
+		chunk.address_keys.push_back(key);
+		chunk.loans.emplace_back(loan);
+	}
+	chunk.line_count = line;
+
+	chunk.errors = validate_persons(chunk.first_names, chunk.last_names, chunk.birthdays);
+	chunk.errors.merge(validate_addresses(chunk.streets, chunk.street_numbers, chunk.zipcodes,
+		chunk.cities, chunk.countries));
+	for(std::size_t i : malformed)
+		chunk.errors.set(i);
+
+	chunk.text.clear();
+	chunk.text.shrink_to_fit();
+}
+
+CsvImport::CsvImport(){}
+
+std::unique_ptr<CsvImport> CsvImport::load(const std::string &path, University &university,
+		std::size_t threads, std::size_t chunk_size)
+{
+	std::FILE *file = std::fopen(path.c_str(), "rb");
+	if(file == NULL)
+		throw std::runtime_error("could not open " + path);
+
+	threads = std::max<std::size_t>(threads, 1);
+	chunk_size = std::max<std::size_t>(chunk_size, 4096);
+	std::unique_ptr<CsvImport> result(new CsvImport());
+
+	std::mutex lock;
+	std::condition_variable work_ready;
+	std::condition_variable chunk_done;
+	std::deque<std::unique_ptr<ImportChunk>> queue;
+	std::map<std::size_t, std::unique_ptr<ImportChunk>> done;
+	std::exception_ptr error;
+	bool finished = false;
+
+	std::vector<std::thread> workers;
+	for(std::size_t t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&](){
+			for(;;)
+			{
+				std::unique_ptr<ImportChunk> chunk;
+				{
+					std::unique_lock<std::mutex> guard(lock);
+					work_ready.wait(guard, [&](){ return !queue.empty() || finished; });
+					if(queue.empty())
+						return;
+					chunk = std::move(queue.front());
+					queue.pop_front();
+				}
+
+				try
+				{
+					parse_chunk(*chunk);
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					error = std::current_exception();
+				}
+
+				std::lock_guard<std::mutex> guard(lock);
+				done.emplace(chunk->sequence, std::move(chunk));
+				chunk_done.notify_one();
+			}
+		});
+	}
+
+	// Die Adressen werden nur vom aufrufenden Thread angelegt, die Schlüssel
+	// liegen in einer deque und werden damit nie verschoben.
+	std::deque<std::string> address_keys;
+	std::unordered_map<std::string_view, Address *> address_index;
+	std::size_t line_offset = 0;
+
+	auto apply = [&](ImportChunk &chunk) {
+		std::size_t students = 0, teachers = 0;
+		for(std::size_t i = 0; i < chunk.lines.size(); i++)
+		{
+			if(!chunk.errors.test(i))
+				(chunk.kinds[i] == ImportKind::Student ? students : teachers)++;
+		}
+		std::int32_t student_number = students > 0 ? Student::allocate_numbers(students) : 0;
+		std::int32_t staff_number = teachers > 0 ? Teacher::allocate_numbers(teachers) : 0;
+
+		std::vector<Student *> enrolled;
+		enrolled.reserve(students);
+		for(std::size_t i = 0; i < chunk.lines.size(); i++)
+		{
+			if(chunk.errors.test(i))
+			{
+				result->m_rejected_lines.emplace_back(line_offset + chunk.lines[i]);
+				continue;
+			}
+
+			Address *address;
+			auto it = address_index.find(chunk.address_keys[i]);
+			if(it != address_index.end())
+				address = it->second;
+			else
+			{
+				const std::string &stored = address_keys.emplace_back(chunk.address_keys[i]);
+				address = result->m_addresses.create(chunk.streets[i], chunk.street_numbers[i],
+					chunk.zipcodes[i], chunk.cities[i], chunk.countries[i], Prevalidated());
+				address_index.emplace(stored, address);
+			}
+
+			if(chunk.kinds[i] == ImportKind::Student)
+			{
+				Student *student = result->m_students.create(chunk.first_names[i], chunk.last_names[i],
+					chunk.birthdays[i], *address, student_number++, Prevalidated());
+				result->m_student_list.emplace_back(student);
+				enrolled.emplace_back(student);
+			}
+			else
+			{
+				Teacher *teacher = result->m_teachers.create(chunk.first_names[i], chunk.last_names[i],
+					chunk.birthdays[i], *address, staff_number++, Prevalidated());
+				result->m_teacher_list.emplace_back(teacher);
+				university.hire(*teacher, chunk.loans[i]);
+			}
+		}
+		university.enroll_batch(enrolled);
+		line_offset += chunk.line_count;
+	};
+
+	std::size_t submitted = 0;
+	std::size_t applied = 0;
+	auto apply_next = [&]() {
+		std::unique_ptr<ImportChunk> chunk;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			chunk_done.wait(guard, [&](){ return done.count(applied) != 0 || error; });
+			if(error)
+				std::rethrow_exception(error);
+			chunk = std::move(done[applied]);
+			done.erase(applied);
+		}
+		apply(*chunk);
+		applied++;
+	};
+
+	try
+	{
+		std::string carry;
+		bool eof = false;
+		while(!eof)
+		{
+			std::string text = std::move(carry);
+			carry.clear();
+			std::size_t old_size = text.size();
+			text.resize(old_size + chunk_size);
+			std::size_t count = std::fread(&text[old_size], 1, chunk_size, file);
+			text.resize(old_size + count);
+			if(count < chunk_size)
+			{
+				if(std::ferror(file))
+					throw std::runtime_error("could not read " + path);
+				eof = true;
+			}
+
+			// Ein Block endet immer am Ende einer Zeile, der Rest wird dem
+			// nächsten Block vorangestellt.
+			if(!eof)
+			{
+				std::size_t last = text.rfind('\n');
+				if(last == std::string::npos)
+				{
+					carry = std::move(text);
+					continue;
+				}
+				carry.assign(text, last + 1, std::string::npos);
+				text.resize(last + 1);
+			}
+			if(text.empty())
+				continue;
+
+			std::unique_ptr<ImportChunk> chunk(new ImportChunk());
+			chunk->sequence = submitted++;
+			chunk->text = std::move(text);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				queue.emplace_back(std::move(chunk));
+			}
+			work_ready.notify_one();
+
+			// Höchstens zwei Blöcke je Thread sind gleichzeitig unterwegs, womit
+			// auch sehr große Dateien mit begrenztem Speicher gelesen werden.
+			while(submitted - applied >= 2 * threads)
+				apply_next();
+		}
+
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			finished = true;
+		}
+		work_ready.notify_all();
+		while(applied < submitted)
+			apply_next();
+	}
+	catch(...)
+	{
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			finished = true;
+			queue.clear();
+		}
+		work_ready.notify_all();
+		for(std::thread &worker : workers)
+			worker.join();
+		std::fclose(file);
+		throw;
+	}
+
+	for(std::thread &worker : workers)
+		worker.join();
+	std::fclose(file);
+	return result;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include "persons.h"
+#include "pool.h"
+#include "university.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Import von Studierenden und Lehrkräften aus einem CSV Export der
+ * Studierendenverwaltung. Jede Zeile beschreibt eine Person:
+ *
+ * art,vorname,nachname,geburtstag,straße,hausnummer,postleitzahl,stadt,land,gehalt
+ *
+ * art ist "student" oder "teacher", der Geburtstag hat die Form JJJJ-MM-TT und
+ * das Gehalt wird nur bei Lehrkräften ausgewertet. Felder dürfen in doppelte
+ * Anführungszeichen gesetzt werden, "" steht darin für ein Anführungszeichen.
+ * Eine erste Zeile welche mit "art" oder "kind" beginnt wird als Kopfzeile
+ * übersprungen.
+ *
+ * Die Datei wird in Blöcken gelesen, welche ein Pool von Threads parallel
+ * zerlegt und mit validate_persons und validate_addresses nach denselben
+ * Regeln wie die Konstruktoren prüft. Die Blöcke werden danach in
+ * Dateireihenfolge übernommen, Matrikel- und Personalnummern werden damit in
+ * Dateireihenfolge vergeben. Gleiche Adressen werden zu einem gemeinsamen
+ * Address Objekt zusammengefasst. Die Studierenden werden gesammelt
+ * immatrikuliert, die Lehrkräfte mit ihrem Gehalt angestellt.
+ *
+ * Ungültige Zeilen werden übersprungen und mit ihrer Zeilennummer vermerkt.
+ * Der Import besitzt alle erzeugten Objekte, diese bleiben bis zu seiner
+ * Zerstörung gültig.
+ */
+class CsvImport {
+private:
+  Pool<Address> m_addresses;
+  Pool<Student> m_students;
+  Pool<Teacher> m_teachers;
+  std::vector<Student *> m_student_list;
+  std::vector<Teacher *> m_teacher_list;
+  std::vector<std::size_t> m_rejected_lines;
+
+  CsvImport();
+
+public:
+  CsvImport(const CsvImport &) = delete;
+  CsvImport &operator=(const CsvImport &) = delete;
+
+  /**
+   * @brief Importiert die Datei in die Universität.
+   *
+   * @throws std::runtime_error Wenn die Datei nicht gelesen werden kann.
+   *
+   * @param path Pfad der CSV Datei.
+   * @param university Universität an welcher die Personen immatrikuliert bzw.
+   * angestellt werden.
+   * @param threads Anzahl der Threads welche die Blöcke zerlegen und prüfen.
+   * @param chunk_size Größe der gelesenen Blöcke in Bytes.
+   */
+  static std::unique_ptr<CsvImport> load(const std::string &path, University &university,
+      std::size_t threads = 4, std::size_t chunk_size = 4 << 20);
+
+  /**
+   * @return Alle importierten Studierenden in Dateireihenfolge.
+   */
+  std::vector<Student *> &students() { return m_student_list; }
+
+  /**
+   * @return Alle importierten Lehrkräfte in Dateireihenfolge.
+   */
+  std::vector<Teacher *> &teachers() { return m_teacher_list; }
+
+  /**
+   * @return Die Anzahl der verschiedenen Adressen.
+   */
+  std::size_t address_count() const { return m_addresses.size(); }
+
+  /**
+   * @return Die Zeilennummern der ungültigen Zeilen, beginnend bei 1.
+   */
+  const std::vector<std::size_t> &rejected_lines() const { return m_rejected_lines; }
+};
@@ -0,0 +1,123 @@
+#include "date.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Anzahl der Einträge welche höchstens threshold sind.
+ */
+static std::size_t count_at_most(const std::int32_t *values, std::size_t count, std::int32_t threshold)
+{
+	std::size_t result = 0;
+	std::size_t i = 0;
+#if defined(__SSE2__)
+	// Ein Vergleich liefert -1 je Spur, abgezogen zählt jede Spur damit die
+	// Einträge über der Grenze.
+	__m128i limit = _mm_set1_epi32(threshold);
+	__m128i above = _mm_setzero_si128();
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+		above = _mm_sub_epi32(above, _mm_cmpgt_epi32(value, limit));
+	}
+	alignas(16) std::uint32_t lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i *>(lanes), above);
+	result = i - (static_cast<std::size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3]);
+#endif
+	for(; i < count; i++)
+		result += values[i] <= threshold;
+	return result;
+}
+
+/*
+ * Anzahl der Einträge im Bereich [low, high].
+ */
+static std::size_t count_between(const std::uint16_t *keys, std::size_t count, std::uint16_t low, std::uint16_t high)
+{
+	std::size_t result = 0;
+	std::size_t i = 0;
+#if defined(__SSE2__)
+	// Die Schlüssel sind kleiner als 2^15, der Vergleich mit Vorzeichen ist
+	// damit korrekt.
+	// Die 16 Bit Zähler je Spur werden spätestens alle 2^15 Runden in 32 Bit
+	// Zähler übertragen.
+	__m128i lower = _mm_set1_epi16(static_cast<std::int16_t>(low - 1));
+	__m128i upper = _mm_set1_epi16(static_cast<std::int16_t>(high + 1));
+	__m128i ones = _mm_set1_epi16(1);
+	__m128i total = _mm_setzero_si128();
+	while(i + 8 <= count)
+	{
+		__m128i inside = _mm_setzero_si128();
+		std::size_t end = std::min(count - (count - i) % 8, i + 8 * 32767);
+		for(; i < end; i += 8)
+		{
+			__m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+			inside = _mm_sub_epi16(inside, _mm_and_si128(_mm_cmpgt_epi16(key, lower), _mm_cmplt_epi16(key, upper)));
+		}
+		total = _mm_add_epi32(total, _mm_madd_epi16(inside, ones));
+	}
+	alignas(16) std::uint32_t lanes[4];
+	_mm_store_si128(reinterpret_cast<__m128i *>(lanes), total);
+	result = static_cast<std::size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#endif
+	for(; i < count; i++)
+		result += keys[i] >= low && keys[i] <= high;
+	return result;
+}
+
+/*
+ * Die Spalte wird in Blöcken durchlaufen, welche in den L1 Cache passen, und
+ * jeder Block für alle Grenzen verglichen.
+ */
+std::vector<std::size_t> count_age_brackets(const std::int32_t *birthdays, std::size_t count, Date today,
+	const std::vector<std::int32_t> &ages)
+{
+	std::vector<std::int32_t> thresholds(ages.size());
+	for(std::size_t k = 0; k < ages.size(); k++)
+	{
+		if(k > 0 && ages[k] <= ages[k - 1])
+			throw std::domain_error("age brackets must be ascending");
+		thresholds[k] = today.add_years(-ages[k]).days();
+	}
+
+	std::vector<std::size_t> at_least(ages.size(), 0);
+	const std::size_t block = 4096;
+	for(std::size_t begin = 0; begin < count; begin += block)
+	{
+		std::size_t length = std::min(block, count - begin);
+		for(std::size_t k = 0; k < thresholds.size(); k++)
+			at_least[k] += count_at_most(birthdays + begin, length, thresholds[k]);
+	}
+
+	std::vector<std::size_t> result(ages.size() + 1);
+	std::size_t older = count;
+	for(std::size_t k = 0; k < ages.size(); k++)
+	{
+		result[k] = older - at_least[k];
+		older = at_least[k];
+	}
+	result[ages.size()] = older;
+	return result;
+}
+
+std::size_t count_birthdays_between(const std::uint16_t *keys, std::size_t count, Date from, Date to)
+{
+	if(to < from)
+		return 0;
+	if(to.days() - from.days() >= 365)
+		return count;
+
+	std::uint16_t low = from.anniversary_key();
+	std::uint16_t high = to.anniversary_key();
+	// Am 1. März eines Jahres ohne Schalttag feiern auch die am 29. Februar
+	// Geborenen.
+	if(from.month() == 3 && from.day() == 1 && !Date::leap_year(from.year()))
+		low = Date::from_civil(2000, 2, 29).anniversary_key();
+
+	if(low <= high)
+		return count_between(keys, count, low, high);
+	return count_between(keys, count, low, 12 * 32 + 31) + count_between(keys, count, 1 * 32 + 1, high);
+}
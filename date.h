@@ -0,0 +1,187 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Tag des gregorianischen Kalenders aufgeteilt in Jahr, Monat und Tag.
+ */
+struct CivilDate {
+  std::int32_t year;
+  std::int32_t month;
+  std::int32_t day;
+};
+
+/**
+ * @brief Kalendertag als Anzahl der Tage seit dem 1.1.1970, ohne Uhrzeit und
+ * Zeitzone. Ein Datum belegt 4 Bytes, Vergleiche sind Vergleiche der Zahlen.
+ * Die Umrechnung in Jahr, Monat und Tag folgt den Algorithmen days_from_civil
+ * und civil_from_days von Howard Hinnant und ist constexpr.
+ */
+class Date {
+private:
+  std::int32_t m_days;
+
+public:
+  /**
+   * @brief Erzeugt den 1.1.1970.
+   */
+  constexpr Date() : m_days(0) {}
+
+  constexpr explicit Date(std::int32_t days) : m_days(days) {}
+
+  /**
+   * @return true Wenn das Jahr ein Schaltjahr ist.
+   */
+  static constexpr bool leap_year(std::int32_t year) { return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0); }
+
+  /**
+   * @return Die Anzahl der Tage des Monats.
+   */
+  static constexpr std::int32_t days_in_month(std::int32_t year, std::int32_t month) {
+    return month == 2 ? (leap_year(year) ? 29 : 28) : (month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31);
+  }
+
+  /**
+   * @return true Wenn der Tag im Kalender existiert.
+   */
+  static constexpr bool valid(std::int32_t year, std::int32_t month, std::int32_t day) {
+    return month >= 1 && month <= 12 && day >= 1 && day <= days_in_month(year, month);
+  }
+
+  /**
+   * @brief Erzeugt das Datum aus Jahr, Monat und Tag, diese werden nicht
+   * geprüft, siehe valid().
+   */
+  static constexpr Date from_civil(std::int32_t year, std::int32_t month, std::int32_t day) {
+    std::int32_t y = month <= 2 ? year - 1 : year;
+    std::int32_t era = (y >= 0 ? y : y - 399) / 400;
+    std::int32_t yoe = y - era * 400;
+    std::int32_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    std::int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return Date(era * 146097 + doe - 719468);
+  }
+
+  /**
+   * @return Der Tag eines Zeitpunktes in UTC, vor 1970 wird abgerundet.
+   */
+  static Date from_time_point(std::chrono::system_clock::time_point time) {
+    std::int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+    std::int64_t days = seconds / 86400;
+    if (seconds % 86400 < 0)
+      days--;
+    return Date(static_cast<std::int32_t>(days));
+  }
+
+  /**
+   * @return Der heutige Tag in UTC.
+   */
+  static Date today() { return from_time_point(std::chrono::system_clock::now()); }
+
+  /**
+   * @return Mitternacht des Tages in UTC.
+   */
+  std::chrono::system_clock::time_point to_time_point() const {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::hours(24) * m_days));
+  }
+
+  constexpr std::int32_t days() const { return m_days; }
+
+  constexpr CivilDate civil() const {
+    std::int32_t z = m_days + 719468;
+    std::int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    std::int32_t doe = z - era * 146097;
+    std::int32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    std::int32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    std::int32_t mp = (5 * doy + 2) / 153;
+    std::int32_t day = doy - (153 * mp + 2) / 5 + 1;
+    std::int32_t month = mp < 10 ? mp + 3 : mp - 9;
+    return CivilDate{yoe + era * 400 + (month <= 2 ? 1 : 0), month, day};
+  }
+
+  constexpr std::int32_t year() const { return civil().year; }
+  constexpr std::int32_t month() const { return civil().month; }
+  constexpr std::int32_t day() const { return civil().day; }
+
+  /**
+   * @return Der Wochentag, 0 ist Sonntag und 6 Samstag.
+   */
+  constexpr std::int32_t weekday() const { return m_days >= -4 ? (m_days + 4) % 7 : (m_days + 5) % 7 + 6; }
+
+  /**
+   * @return Das Datum um die Anzahl Tage verschoben.
+   */
+  constexpr Date add_days(std::int32_t days) const { return Date(m_days + days); }
+
+  /**
+   * @return Das Datum um die Anzahl Jahre verschoben. Aus dem 29. Februar wird
+   * in Jahren ohne Schalttag der 28. Februar.
+   */
+  constexpr Date add_years(std::int32_t years) const {
+    CivilDate date = civil();
+    std::int32_t year = date.year + years;
+    std::int32_t day = date.day <= days_in_month(year, date.month) ? date.day : days_in_month(year, date.month);
+    return from_civil(year, date.month, day);
+  }
+
+  /**
+   * @return Das Alter in vollendeten Jahren am Tag today. Wer am 29. Februar
+   * geboren ist, wird in Jahren ohne Schalttag am 1. März ein Jahr älter.
+   */
+  constexpr std::int32_t age_at(Date today) const {
+    CivilDate birth = civil();
+    CivilDate now = today.civil();
+    bool before = now.month < birth.month || (now.month == birth.month && now.day < birth.day);
+    return now.year - birth.year - (before ? 1 : 0);
+  }
+
+  /**
+   * @return Monat und Tag als Zahl month * 32 + day, aufsteigend im Verlauf
+   * eines Jahres. Wird für die Suche nach Geburtstagen unabhängig vom Jahr
+   * genutzt.
+   */
+  constexpr std::uint16_t anniversary_key() const {
+    CivilDate date = civil();
+    return static_cast<std::uint16_t>(date.month * 32 + date.day);
+  }
+
+  constexpr bool operator==(Date other) const { return m_days == other.m_days; }
+  constexpr bool operator!=(Date other) const { return m_days != other.m_days; }
+  constexpr bool operator<(Date other) const { return m_days < other.m_days; }
+  constexpr bool operator<=(Date other) const { return m_days <= other.m_days; }
+  constexpr bool operator>(Date other) const { return m_days > other.m_days; }
+  constexpr bool operator>=(Date other) const { return m_days >= other.m_days; }
+};
+
+static_assert(sizeof(Date) == 4, "Date must stay 32 bit");
+static_assert(Date::from_civil(1970, 1, 1).days() == 0, "epoch");
+static_assert(Date::from_civil(2000, 3, 1).days() == 11017, "days_from_civil");
+static_assert(Date(11016).civil().month == 2 && Date(11016).civil().day == 29, "civil_from_days");
+static_assert(Date::from_civil(2004, 2, 29).age_at(Date::from_civil(2005, 2, 28)) == 0, "age before March");
+static_assert(Date::from_civil(2004, 2, 29).age_at(Date::from_civil(2005, 3, 1)) == 1, "age in March");
+
+/**
+ * @brief Zählt die Personen je Altersstufe über eine Spalte von Geburtstagen
+ * in Tagen seit dem 1.1.1970. Das Alter wird exakt bestimmt, indem je Grenze
+ * der späteste Geburtstag berechnet wird, mit welchem man am Tag today das
+ * Alter erreicht hat. Die Spalte wird danach nur noch mit diesen Grenzen
+ * verglichen, auf Maschinen mit SSE2 vier Geburtstage auf einmal.
+ *
+ * @param ages Aufsteigende Altersgrenzen a_0 < a_1 < ... < a_n-1.
+ * @return n + 1 Anzahlen, Eintrag 0 für ein Alter unter a_0, Eintrag k für
+ * ein Alter in [a_k-1, a_k) und Eintrag n für ein Alter ab a_n-1.
+ * @throws std::domain_error Wenn die Altersgrenzen nicht aufsteigend sind.
+ */
+std::vector<std::size_t> count_age_brackets(const std::int32_t *birthdays, std::size_t count, Date today,
+                                            const std::vector<std::int32_t> &ages);
+
+/**
+ * @brief Zählt die Personen, welche im Zeitraum [from, to] Geburtstag haben,
+ * über eine Spalte von Date::anniversary_key(). Wer am 29. Februar geboren
+ * ist, feiert in Jahren ohne Schalttag am 1. März. Umfasst der Zeitraum ein
+ * Jahr oder mehr, werden alle Personen gezählt. Auf Maschinen mit SSE2 werden
+ * acht Einträge auf einmal verglichen.
+ */
+std::size_t count_birthdays_between(const std::uint16_t *keys, std::size_t count, Date from, Date to);
@@ -0,0 +1,276 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+class Course;
+
+template <typename T> struct Enrollment;
+
+/**
+ * @brief Verkettung einer Kante innerhalb einer der beiden Listen.
+ */
+template <typename T> struct EnrollmentLinks {
+  Enrollment<T> *prev;
+  Enrollment<T> *next;
+};
+
+/**
+ * @brief Kante der Beziehung zwischen einem Seminar und einem Mitglied, also
+ * einem Studierenden oder einer Lehrkraft. Jede Kante existiert genau einmal
+ * und hängt gleichzeitig in der Liste des Seminars (in_course) und in der
+ * Liste des Mitglieds (of_member). Wer die Kante kennt, kann sie damit aus
+ * beiden Listen in O(1) aushängen.
+ */
+template <typename T> struct Enrollment {
+  Course *course;
+  T *member;
+  EnrollmentLinks<T> in_course;
+  EnrollmentLinks<T> of_member;
+};
+
+/**
+ * @brief Seite der Beziehung, an welcher eine EnrollmentList hängt.
+ */
+enum class EnrollmentSide { course, member };
+
+/**
+ * @brief Intrusive doppelt verkettete Liste von Kanten. Eine Liste mit Side
+ * course hängt an einem Seminar und liefert dessen Mitglieder, eine Liste mit
+ * Side member hängt an einem Mitglied und liefert dessen Seminare.
+ *
+ * Die Liste besitzt die Kanten nicht, sie verkettet sie nur über die Zeiger in
+ * den Kanten selbst. Einhängen am Ende und Aushängen einer Kante kosten O(1)
+ * ohne Speicheranforderung, die Reihenfolge ist die des Einhängens.
+ */
+template <typename T, EnrollmentSide Side> class EnrollmentList {
+public:
+  typedef typename std::conditional<Side == EnrollmentSide::course, T *, Course *>::type value_type;
+
+  class iterator {
+  private:
+    const Enrollment<T> *m_edge;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef typename EnrollmentList::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const value_type *pointer;
+    typedef value_type reference;
+
+    explicit iterator(const Enrollment<T> *edge) : m_edge(edge) {}
+
+    value_type operator*() const { return EnrollmentList::value(*m_edge); }
+
+    iterator &operator++() {
+      m_edge = EnrollmentList::links(*m_edge).next;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      iterator previous = *this;
+      ++*this;
+      return previous;
+    }
+
+    bool operator==(const iterator &other) const { return m_edge == other.m_edge; }
+    bool operator!=(const iterator &other) const { return m_edge != other.m_edge; }
+  };
+
+private:
+  Enrollment<T> *m_first;
+  Enrollment<T> *m_last;
+  std::size_t m_size;
+
+  static EnrollmentLinks<T> &links(Enrollment<T> &edge) {
+    if constexpr (Side == EnrollmentSide::course)
+      return edge.in_course;
+    else
+      return edge.of_member;
+  }
+
+  static const EnrollmentLinks<T> &links(const Enrollment<T> &edge) {
+    if constexpr (Side == EnrollmentSide::course)
+      return edge.in_course;
+    else
+      return edge.of_member;
+  }
+
+  static value_type value(const Enrollment<T> &edge) {
+    if constexpr (Side == EnrollmentSide::course)
+      return edge.member;
+    else
+      return edge.course;
+  }
+
+public:
+  EnrollmentList() : m_first(NULL), m_last(NULL), m_size(0) {}
+  EnrollmentList(const EnrollmentList &) = delete;
+  EnrollmentList &operator=(const EnrollmentList &) = delete;
+
+  /**
+   * @brief Hängt die Kante am Ende der Liste ein, sie darf in dieser Liste
+   * noch nicht enthalten sein.
+   */
+  void push_back(Enrollment<T> &edge) {
+    EnrollmentLinks<T> &link = links(edge);
+    link.prev = m_last;
+    link.next = NULL;
+    if (m_last != NULL)
+      links(*m_last).next = &edge;
+    else
+      m_first = &edge;
+    m_last = &edge;
+    m_size++;
+  }
+
+  /**
+   * @brief Hängt die Kante aus der Liste aus, sie muss in dieser Liste
+   * enthalten sein.
+   */
+  void unlink(Enrollment<T> &edge) {
+    EnrollmentLinks<T> &link = links(edge);
+    if (link.prev != NULL)
+      links(*link.prev).next = link.next;
+    else
+      m_first = link.next;
+    if (link.next != NULL)
+      links(*link.next).prev = link.prev;
+    else
+      m_last = link.prev;
+    link.prev = link.next = NULL;
+    m_size--;
+  }
+
+  std::size_t size() const { return m_size; }
+
+  bool empty() const { return m_size == 0; }
+
+  value_type front() const { return value(*m_first); }
+
+  value_type back() const { return value(*m_last); }
+
+  iterator begin() const { return iterator(m_first); }
+
+  iterator end() const { return iterator(NULL); }
+};
+
+/**
+ * @brief Speicher aller Kanten eines Seminars zu seinen Mitgliedern. Die
+ * Tabelle legt jede Kante genau einmal an, hängt sie in die Liste des
+ * Seminars sowie in die Liste des Mitglieds ein und findet sie über den
+ * Schlüssel des Mitglieds (z.B. die Matrikelnummer) in O(1) wieder.
+ *
+ * Die Kanten liegen in Blöcken mit stabiler Adresse, deren Größe sich bis zu
+ * einer Obergrenze verdoppelt. Ausgehängte Kanten kommen auf eine Freiliste
+ * und werden beim nächsten Einfügen wiederverwendet. Die Tabelle gehört dem
+ * Seminar und wird nur unter dessen Sperre verändert, es gibt damit keinen
+ * gemeinsamen Zustand zwischen den Seminaren.
+ */
+template <typename T> class EnrollmentTable {
+private:
+  typedef Enrollment<T> Edge;
+
+  static constexpr std::size_t s_first_block = 4;
+  static constexpr std::size_t s_max_block = 4096;
+
+  std::vector<std::unique_ptr<Edge[]>> m_blocks;
+  std::size_t m_block_capacity;
+  std::size_t m_block_used;
+  Edge *m_free;
+  std::unordered_map<std::int32_t, Edge *> m_index;
+  EnrollmentList<T, EnrollmentSide::course> m_members;
+
+  Edge *allocate() {
+    if (m_free != NULL) {
+      Edge *edge = m_free;
+      m_free = edge->in_course.next;
+      return edge;
+    }
+    if (m_blocks.empty() || m_block_used == m_block_capacity) {
+      m_block_capacity = m_blocks.empty() ? s_first_block : std::min(m_block_capacity * 2, s_max_block);
+      m_blocks.emplace_back(new Edge[m_block_capacity]);
+      m_block_used = 0;
+    }
+    return &m_blocks.back()[m_block_used++];
+  }
+
+public:
+  EnrollmentTable() : m_block_capacity(0), m_block_used(0), m_free(NULL) {}
+  EnrollmentTable(const EnrollmentTable &) = delete;
+  EnrollmentTable &operator=(const EnrollmentTable &) = delete;
+
+  /**
+   * @brief Legt die Kante zwischen Seminar und Mitglied an, falls der
+   * Schlüssel noch nicht vergeben ist, und hängt sie am Ende beider Listen
+   * ein.
+   *
+   * @param courses Die Liste der Seminare des Mitglieds.
+   * @return true Wenn die Kante angelegt wurde.
+   */
+  bool insert(std::int32_t key, Course *course, T *member, EnrollmentList<T, EnrollmentSide::member> &courses) {
+    auto result = m_index.emplace(key, nullptr);
+    if (!result.second)
+      return false;
+    Edge *edge = allocate();
+    edge->course = course;
+    edge->member = member;
+    result.first->second = edge;
+    m_members.push_back(*edge);
+    courses.push_back(*edge);
+    return true;
+  }
+
+  /**
+   * @brief Hängt die Kante mit dem Schlüssel aus beiden Listen aus, falls sie
+   * existiert.
+   *
+   * @param courses Die Liste der Seminare des Mitglieds.
+   * @return true Wenn eine Kante entfernt wurde.
+   */
+  bool erase(std::int32_t key, EnrollmentList<T, EnrollmentSide::member> &courses) {
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+      return false;
+    Edge *edge = it->second;
+    m_index.erase(it);
+    m_members.unlink(*edge);
+    courses.unlink(*edge);
+    edge->in_course.next = m_free;
+    m_free = edge;
+    return true;
+  }
+
+  bool contains(std::int32_t key) const { return m_index.count(key) != 0; }
+
+  /**
+   * @brief Reserviert das Schlüsselverzeichnis und den Speicher für
+   * mindestens count Kanten. Reicht der Rest des aktuellen Blocks nicht aus,
+   * wird ein Block mit genau den fehlenden Kanten angelegt.
+   */
+  void reserve(std::size_t count) {
+    m_index.reserve(count);
+    if (count <= size() || m_free != NULL)
+      return;
+    std::size_t missing = count - size();
+    if (!m_blocks.empty() && m_block_capacity - m_block_used >= missing)
+      return;
+    m_block_capacity = missing;
+    m_blocks.emplace_back(new Edge[missing]);
+    m_block_used = 0;
+  }
+
+  std::size_t size() const { return m_members.size(); }
+
+  bool empty() const { return m_members.empty(); }
+
+  /**
+   * @return Die Mitglieder des Seminars in der Reihenfolge des Einfügens.
+   */
+  const EnrollmentList<T, EnrollmentSide::course> &members() const { return m_members; }
+};
@@ -0,0 +1,206 @@
+#include "federation.h"
+#include "person_index.h"
+#include "persons.h"
+#include "university.h"
+#include <stdexcept>
+
+void Federation::DirectoryUpdater::enrolled(const Student &student)
+{
+	m_federation.set_home(student.student_number(), m_shard);
+}
+
+void Federation::DirectoryUpdater::exmatriculated(const Student &student)
+{
+	m_federation.clear_home(student.student_number(), m_shard);
+}
+
+Federation::~Federation()
+{
+	for(std::unique_ptr<Shard> &shard : m_shards)
+		shard->university.remove_listener(shard->updater);
+}
+
+void Federation::set_home(std::int32_t student_number, std::size_t shard)
+{
+	Stripe &entry = stripe(student_number);
+	std::lock_guard<std::mutex> guard(entry.lock);
+	entry.homes[student_number] = shard;
+}
+
+/*
+ * Beim Wechsel wird zuerst an der alten Universität exmatrikuliert, der
+ * Eintrag wird trotzdem nur entfernt wenn er noch auf diese Universität zeigt.
+ */
+void Federation::clear_home(std::int32_t student_number, std::size_t shard)
+{
+	Stripe &entry = stripe(student_number);
+	std::lock_guard<std::mutex> guard(entry.lock);
+	auto it = entry.homes.find(student_number);
+	if(it != entry.homes.end() && it->second == shard)
+		entry.homes.erase(it);
+}
+
+/*
+ * Setzt den Eintrag nur dann auf shard, wenn er noch auf from zeigt bzw. bei
+ * s_no_shard noch fehlt. Prüfen und Setzen geschehen unter derselben Sperre,
+ * von mehreren gleichzeitigen Wechseln gelingt damit genau einer.
+ */
+bool Federation::claim_home(std::int32_t student_number, std::size_t from, std::size_t shard)
+{
+	Stripe &entry = stripe(student_number);
+	std::lock_guard<std::mutex> guard(entry.lock);
+	auto it = entry.homes.find(student_number);
+	std::size_t current = it != entry.homes.end() ? it->second : s_no_shard;
+	if(current != from)
+		return false;
+	if(it != entry.homes.end())
+		it->second = shard;
+	else
+		entry.homes.emplace(student_number, shard);
+	return true;
+}
+
+std::size_t Federation::add_shard(University &university)
+{
+	for(const std::unique_ptr<Shard> &shard : m_shards)
+	{
+		if(&shard->university == &university)
+			throw std::domain_error("university is already part of the federation");
+	}
+	for(Student *student : university.list_students())
+	{
+		if(home(student->student_number()) != s_no_shard)
+			throw std::domain_error("student is already enrolled in the federation");
+	}
+
+	std::size_t index = m_shards.size();
+	m_shards.emplace_back(new Shard(university, *this, index));
+	for(Student *student : university.list_students())
+		set_home(student->student_number(), index);
+	university.add_listener(m_shards.back()->updater);
+	return index;
+}
+
+std::size_t Federation::home(std::int32_t student_number) const
+{
+	const Stripe &entry = stripe(student_number);
+	std::lock_guard<std::mutex> guard(entry.lock);
+	auto it = entry.homes.find(student_number);
+	return it != entry.homes.end() ? it->second : s_no_shard;
+}
+
+Student *Federation::find_student(std::int32_t student_number) const
+{
+	for(;;)
+	{
+		std::size_t shard = home(student_number);
+		if(shard == s_no_shard)
+			return NULL;
+
+		std::shared_lock<std::shared_mutex> guard(m_shards[shard]->lock);
+		if(Student *student = m_shards[shard]->university.find_student(student_number))
+			return student;
+		if(home(student_number) == shard)
+			return NULL;
+	}
+}
+
+/*
+ * Die Universität des Studierenden kann sich zwischen dem Nachschlagen und dem
+ * Sperren ändern, dann wird mit der neuen Universität von vorne begonnen. Hat
+ * der Studierende noch keine Universität, sperren zwei gleichzeitige Aufrufe
+ * verschiedene Universitäten. Erst claim_home entscheidet dann, welcher von
+ * beiden den Studierenden einschreibt, der andere beginnt von vorne und
+ * wartet auf die Sperre der neuen Universität.
+ */
+void Federation::enroll(Student &student, std::size_t shard)
+{
+	for(;;)
+	{
+		std::size_t from = home(student.student_number());
+		std::size_t first = std::min(from, shard);
+		std::size_t second = std::max(from, shard);
+
+		std::unique_lock<std::shared_mutex> first_guard(m_shards[first]->lock);
+		std::unique_lock<std::shared_mutex> second_guard;
+		if(second != first && second != s_no_shard)
+			second_guard = std::unique_lock<std::shared_mutex>(m_shards[second]->lock);
+
+		// Das Verzeichnis zeigt schon vor dem Wechsel auf die neue
+		// Universität, damit der Studierende zwischen Exmatrikulation und
+		// Immatrikulation für find_student nicht verschwindet.
+		if(!claim_home(student.student_number(), from, shard))
+			continue;
+		student.enroll(m_shards[shard]->university);
+		return;
+	}
+}
+
+void Federation::exmatriculate(Student &student)
+{
+	for(;;)
+	{
+		std::size_t from = home(student.student_number());
+		if(from == s_no_shard)
+			return;
+
+		std::unique_lock<std::shared_mutex> guard(m_shards[from]->lock);
+		if(home(student.student_number()) != from)
+			continue;
+		student.exmatriculate();
+		return;
+	}
+}
+
+std::size_t Federation::student_count(std::size_t threads) const
+{
+	std::atomic<std::size_t> count(0);
+	for_each_shard([&](std::size_t, University &university){
+		count += university.list_students().size();
+	}, threads);
+	return count;
+}
+
+std::vector<Student *> Federation::students_in_city(std::string_view city, std::size_t threads) const
+{
+	std::vector<std::vector<Student *>> found(m_shards.size());
+	for_each_shard([&](std::size_t index, University &university){
+		if(const PersonIndex<Student> *index_of_students = university.student_index())
+		{
+			found[index] = index_of_students->by_city(city);
+			return;
+		}
+		for(Student *student : university.list_students())
+		{
+			if(student->place_of_residence().city() == city)
+				found[index].push_back(student);
+		}
+	}, threads);
+
+	std::vector<Student *> result;
+	for(std::vector<Student *> &students : found)
+		result.insert(result.end(), students.begin(), students.end());
+	return result;
+}
+
+PayrollSummary Federation::payroll(std::size_t threads) const
+{
+	std::vector<PayrollSummary> summaries(m_shards.size());
+	for_each_shard([&](std::size_t index, University &university){
+		summaries[index] = university.payroll().summary();
+	}, threads);
+
+	PayrollSummary result = {0, 0, 0, 0, {}};
+	for(const PayrollSummary &summary : summaries)
+	{
+		if(summary.count == 0)
+			continue;
+		result.min = result.count == 0 ? summary.min : std::min(result.min, summary.min);
+		result.max = result.count == 0 ? summary.max : std::max(result.max, summary.max);
+		result.total += summary.total;
+		result.count += summary.count;
+		for(std::size_t bucket = 0; bucket < PayrollSummary::s_buckets; bucket++)
+			result.histogram[bucket] += summary.histogram[bucket];
+	}
+	return result;
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include "listener.h"
+#include "payroll.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Student;
+class University;
+
+/**
+ * @brief Verbund mehrerer Universitäten (Shards) mit einem gemeinsamen
+ * Verzeichnis, welches zu jeder Matrikelnummer die Universität angibt an
+ * welcher der Studierende immatrikuliert ist. Matrikelnummern werden
+ * prozessweit vergeben und sind damit über alle Universitäten eindeutig.
+ *
+ * Jede Universität ist durch eine eigene Lese- und Schreibsperre geschützt,
+ * Veränderungen an verschiedenen Universitäten laufen damit unabhängig
+ * voneinander. Ein Wechsel sperrt beide Universitäten in der Reihenfolge
+ * ihrer Nummer, wodurch keine Verklemmungen entstehen. Das Verzeichnis wird
+ * über je einen MutationListener je Universität nachgeführt und ist über die
+ * Matrikelnummern auf eine feste Anzahl von Sperren verteilt (lock striping).
+ * Abfragen über alle Universitäten werden auf mehrere Threads verteilt, jede
+ * Universität wird dabei nur gelesen.
+ *
+ * Solange die Universitäten Teil der Föderation sind, dürfen sie nur über
+ * deren Methoden verändert werden. Die Föderation muss vor den Universitäten
+ * zerstört werden.
+ */
+class Federation {
+public:
+  static constexpr std::size_t s_no_shard = std::numeric_limits<std::size_t>::max();
+
+private:
+  static constexpr std::size_t s_stripes = 64;
+
+  class DirectoryUpdater : public MutationListener {
+  private:
+    Federation &m_federation;
+    std::size_t m_shard;
+
+  public:
+    DirectoryUpdater(Federation &federation, std::size_t shard) : m_federation(federation), m_shard(shard) {}
+
+    void enrolled(const Student &student) override;
+    void exmatriculated(const Student &student) override;
+  };
+
+  struct Shard {
+    University &university;
+    mutable std::shared_mutex lock;
+    DirectoryUpdater updater;
+
+    Shard(University &university, Federation &federation, std::size_t index)
+        : university(university), updater(federation, index) {}
+  };
+
+  struct Stripe {
+    mutable std::mutex lock;
+    std::unordered_map<std::int32_t, std::size_t> homes;
+  };
+
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  std::array<Stripe, s_stripes> m_directory;
+
+  Stripe &stripe(std::int32_t student_number) {
+    return m_directory[static_cast<std::uint32_t>(student_number) % s_stripes];
+  }
+  const Stripe &stripe(std::int32_t student_number) const {
+    return m_directory[static_cast<std::uint32_t>(student_number) % s_stripes];
+  }
+  void set_home(std::int32_t student_number, std::size_t shard);
+  void clear_home(std::int32_t student_number, std::size_t shard);
+  bool claim_home(std::int32_t student_number, std::size_t from, std::size_t shard);
+
+public:
+  Federation() = default;
+  Federation(const Federation &) = delete;
+  Federation &operator=(const Federation &) = delete;
+
+  /**
+   * @brief Meldet die Föderation von allen Universitäten ab.
+   */
+  ~Federation();
+
+  /**
+   * @brief Nimmt die Universität in die Föderation auf und trägt ihre
+   * Studierenden in das Verzeichnis ein. Nicht threadsicher, die Universitäten
+   * werden vor der ersten Veränderung über die Föderation aufgenommen.
+   *
+   * @return Die Nummer der Universität in der Föderation.
+   * @throws std::domain_error Wenn die Universität bereits aufgenommen wurde
+   * oder einer ihrer Studierenden bereits an einer anderen Universität der
+   * Föderation geführt wird.
+   */
+  std::size_t add_shard(University &university);
+
+  /**
+   * @return Die Anzahl der Universitäten.
+   */
+  std::size_t shards() const { return m_shards.size(); }
+
+  /**
+   * @return Die Universität mit der Nummer.
+   */
+  University &shard(std::size_t index) { return m_shards[index]->university; }
+
+  /**
+   * @param student_number Matrikelnummer des Studierenden.
+   * @return Die Nummer der Universität an welcher der Studierende
+   * immatrikuliert ist oder s_no_shard.
+   */
+  std::size_t home(std::int32_t student_number) const;
+
+  /**
+   * @return Student* Der Studierende oder NULL falls er an keiner Universität
+   * der Föderation immatrikuliert ist.
+   */
+  Student *find_student(std::int32_t student_number) const;
+
+  /**
+   * @brief Immatrikuliert den Studierenden an der Universität. Ist er an einer
+   * anderen Universität der Föderation immatrikuliert, wechselt er, beide
+   * Universitäten bleiben dabei bis zum Abschluss des Wechsels gesperrt.
+   *
+   * @param student Studierender, welcher nicht an einer Universität außerhalb
+   * der Föderation immatrikuliert sein darf.
+   * @param shard Nummer der Universität.
+   */
+  void enroll(Student &student, std::size_t shard);
+
+  /**
+   * @brief Exmatrikuliert den Studierenden von seiner Universität, falls er an
+   * einer Universität der Föderation immatrikuliert ist.
+   */
+  void exmatriculate(Student &student);
+
+  /**
+   * @brief Ruft die Funktion unter der Schreibsperre der Universität auf, für
+   * alle anderen Veränderungen wie Anstellungen oder Seminare.
+   */
+  template <typename F> void modify(std::size_t shard, F function) {
+    std::unique_lock<std::shared_mutex> guard(m_shards[shard]->lock);
+    function(m_shards[shard]->university);
+  }
+
+  /**
+   * @brief Ruft die Funktion für jede Universität mit deren Nummer und der
+   * Universität unter deren Lesesperre auf. Die Universitäten werden auf
+   * höchstens threads Threads verteilt, die Funktion muss damit threadsicher
+   * sein und darf die Universität nicht verändern. Jede Universität wird in
+   * einem konsistenten Zustand gesehen, alle gemeinsam aber nicht: ein
+   * gleichzeitiger Wechsel kann doppelt oder gar nicht gesehen werden.
+   */
+  template <typename F> void for_each_shard(F function, std::size_t threads = 4) const {
+    std::size_t count = m_shards.size();
+    threads = std::max<std::size_t>(1, std::min(threads, count));
+    std::atomic<std::size_t> next(0);
+    auto work = [&]() {
+      for (std::size_t index = next++; index < count; index = next++) {
+        std::shared_lock<std::shared_mutex> guard(m_shards[index]->lock);
+        function(index, m_shards[index]->university);
+      }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads; i++)
+      workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  /**
+   * @return Die Anzahl der Studierenden aller Universitäten.
+   */
+  std::size_t student_count(std::size_t threads = 4) const;
+
+  /**
+   * @return Alle Studierenden aller Universitäten, welche in der Stadt wohnen,
+   * nach Universität geordnet. Universitäten mit Suchindizes werden über den
+   * Index durchsucht, alle anderen vollständig.
+   */
+  std::vector<Student *> students_in_city(std::string_view city, std::size_t threads = 4) const;
+
+  /**
+   * @return Die zusammengefassten Gehaltskennzahlen aller Universitäten.
+   */
+  PayrollSummary payroll(std::size_t threads = 4) const;
+};
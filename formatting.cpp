@@ -0,0 +1,93 @@
+#include "formatting.h"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+static const char s_weekdays[] = "SunMonTueWedThuFriSat";
+static const char s_months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+/*
+ * Ein Eintrag des Caches. Zwischengespeichert werden nur Jahre mit vier
+ * Stellen, deren Text ist immer 25 Zeichen lang.
+ */
+struct CachedDate {
+	std::int32_t days;
+	bool filled;
+	char text[27];
+};
+
+static const std::size_t s_cached_dates = 1024;
+static const std::size_t s_cached_length = 25;
+
+/*
+ * Schreibt den Tag wie std::asctime nach out, dies muss Platz für 32 Zeichen
+ * haben.
+ *
+ * @return Die Anzahl der geschriebenen Zeichen.
+ */
+static std::size_t format_date(Date date, char *out)
+{
+	CivilDate civil = date.civil();
+	std::memcpy(out, s_weekdays + 3 * date.weekday(), 3);
+	out[3] = ' ';
+	std::memcpy(out + 4, s_months + 3 * (civil.month - 1), 3);
+	out[7] = ' ';
+	out[8] = civil.day < 10 ? ' ' : static_cast<char>('0' + civil.day / 10);
+	out[9] = static_cast<char>('0' + civil.day % 10);
+	std::memcpy(out + 10, " 00:00:00 ", 10);
+	std::to_chars_result result = std::to_chars(out + 20, out + 31, civil.year);
+	*result.ptr = '\n';
+	return result.ptr + 1 - out;
+}
+
+void append_date(std::string &buffer, Date date)
+{
+	static thread_local CachedDate cache[s_cached_dates];
+
+	CachedDate &entry = cache[static_cast<std::uint32_t>(date.days()) % s_cached_dates];
+	if(!entry.filled || entry.days != date.days())
+	{
+		char text[32];
+		std::size_t length = format_date(date, text);
+		if(length != s_cached_length)
+		{
+			buffer.append(text, length);
+			return;
+		}
+		std::memcpy(entry.text, text, length);
+		entry.days = date.days();
+		entry.filled = true;
+	}
+	buffer.append(entry.text, s_cached_length);
+}
+
+void append_all(std::string &buffer, std::initializer_list<std::string_view> parts)
+{
+	std::size_t length = 0;
+	for(std::string_view part : parts)
+		length += part.size();
+
+	std::size_t offset = buffer.size();
+	buffer.resize(offset + length);
+	char *out = &buffer[0] + offset;
+	for(std::string_view part : parts)
+	{
+		std::memcpy(out, part.data(), part.size());
+		out += part.size();
+	}
+}
+
+void append_roster_line(std::string &buffer, std::size_t position, std::string_view first_name,
+	std::string_view last_name)
+{
+	char digits[24];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), position);
+	append_all(buffer, {std::string_view(digits, result.ptr - digits), " ", first_name, " ", last_name, "\n"});
+}
+
+void append_roster_line(std::string &buffer, std::size_t position, std::string_view name)
+{
+	char digits[24];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), position);
+	append_all(buffer, {std::string_view(digits, result.ptr - digits), " ", name, "\n"});
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "date.h"
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Hängt den Tag im Format von std::asctime bzw. std::ctime an, z.B.
+ * "Thu Jan  5 00:00:00 1989\n". Als Uhrzeit steht immer Mitternacht.
+ *
+ * Im Gegensatz zu std::asctime und std::ctime nutzt die Funktion keinen
+ * gemeinsamen statischen Speicher, keine Locale und keine Zeitzone. Sie ist
+ * damit reentrant, kann von beliebig vielen Threads gleichzeitig genutzt
+ * werden und fordert keinen Speicher an, solange der Puffer groß genug ist.
+ * Jeder Thread hält einen kleinen Cache der zuletzt formatierten Tage.
+ */
+void append_date(std::string &buffer, Date date);
+
+/**
+ * @brief Hängt alle Teile hintereinander an, wobei der Puffer höchstens
+ * einmal vergrößert wird. Die Teile dürfen nicht in den Puffer selbst zeigen.
+ */
+void append_all(std::string &buffer, std::initializer_list<std::string_view> parts);
+
+/**
+ * @brief Hängt eine Zeile einer nummerierten Aufzählung an, z.B. "3 Anna
+ * Meier\n" für die Mitglieder einer Universität.
+ *
+ * @param position Die Nummer der Zeile, beginnend bei 1.
+ */
+void append_roster_line(std::string &buffer, std::size_t position, std::string_view first_name,
+                        std::string_view last_name);
+
+/**
+ * @brief Hängt eine Zeile einer nummerierten Aufzählung mit nur einem Namen
+ * an, z.B. "1 Mathematik\n" für die Seminare.
+ */
+void append_roster_line(std::string &buffer, std::size_t position, std::string_view name);
@@ -0,0 +1,89 @@
+#include "instrumentation.h"
+#include <cstdio>
+
+std::atomic<Operation *> Operation::s_first(NULL);
+
+/*
+ * Liefert die Stufe unter welcher der Anteil fraction aller Laufzeiten liegt.
+ */
+static std::size_t percentile_bucket(const Operation &operation, double fraction)
+{
+	std::uint64_t calls = operation.calls();
+	std::uint64_t seen = 0;
+	for(std::size_t bucket = 0; bucket < Operation::s_buckets; bucket++)
+	{
+		seen += operation.histogram(bucket);
+		if(seen > 0 && seen >= fraction * calls)
+			return bucket;
+	}
+	return Operation::s_buckets - 1;
+}
+
+void Instrumentation::append_to(std::string &buffer)
+{
+	char line[160];
+	std::snprintf(line, sizeof(line), "%-28s %12s %12s %10s %10s %12s\n",
+		"operation", "calls", "avg_ns", "p50_ns<", "p99_ns<", "scanned/call");
+	buffer += line;
+	for(const Operation *operation = Operation::first(); operation != NULL; operation = operation->next())
+	{
+		std::uint64_t calls = operation->calls();
+		if(calls == 0)
+			continue;
+		std::snprintf(line, sizeof(line), "%-28s %12llu %12.1f %10llu %10llu %12.2f\n", operation->name(),
+			static_cast<unsigned long long>(calls), operation->nanoseconds() / static_cast<double>(calls),
+			1ull << percentile_bucket(*operation, 0.5), 1ull << percentile_bucket(*operation, 0.99),
+			operation->scanned() / static_cast<double>(calls));
+		buffer += line;
+	}
+}
+
+void Instrumentation::append_json(std::string &buffer)
+{
+	char number[32];
+	buffer += "{\"enabled\":";
+	buffer += enabled() ? "true" : "false";
+	buffer += ",\"operations\":[";
+	bool first = true;
+	for(const Operation *operation = Operation::first(); operation != NULL; operation = operation->next())
+	{
+		if(operation->calls() == 0)
+			continue;
+		if(!first)
+			buffer += ',';
+		first = false;
+
+		buffer += "{\"name\":\"";
+		buffer += operation->name();
+		std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(operation->calls()));
+		buffer += "\",\"calls\":";
+		buffer += number;
+		std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(operation->nanoseconds()));
+		buffer += ",\"ns\":";
+		buffer += number;
+		std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(operation->scanned()));
+		buffer += ",\"scanned\":";
+		buffer += number;
+		buffer += ",\"histogram\":[";
+		bool first_bucket = true;
+		for(std::size_t bucket = 0; bucket < Operation::s_buckets; bucket++)
+		{
+			std::uint64_t count = operation->histogram(bucket);
+			if(count == 0)
+				continue;
+			if(!first_bucket)
+				buffer += ',';
+			first_bucket = false;
+			std::snprintf(number, sizeof(number), "[%zu,%llu]", bucket, static_cast<unsigned long long>(count));
+			buffer += number;
+		}
+		buffer += "]}";
+	}
+	buffer += "]}";
+}
+
+void Instrumentation::reset()
+{
+	for(Operation *operation = Operation::first(); operation != NULL; operation = operation->next())
+		operation->reset();
+}
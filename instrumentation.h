@@ -0,0 +1,150 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Zähler einer instrumentierten Operation: Anzahl der Aufrufe, eine
+ * Verteilung der Laufzeiten in Zweierpotenzen von Nanosekunden und die Anzahl
+ * der dabei besuchten Elemente ("Scanlänge"). Alle Zähler sind atomar und
+ * werden ohne Sperren erhöht.
+ *
+ * Die Operationen tragen sich bei ihrer ersten Verwendung in eine globale
+ * Liste ein, welche Instrumentation ausgibt.
+ */
+class Operation {
+public:
+  static constexpr std::size_t s_buckets = 40;
+
+private:
+  const char *m_name;
+  std::atomic<std::uint64_t> m_calls;
+  std::atomic<std::uint64_t> m_nanoseconds;
+  std::atomic<std::uint64_t> m_scanned;
+  std::atomic<std::uint64_t> m_histogram[s_buckets];
+  Operation *m_next;
+
+  static std::atomic<Operation *> s_first;
+
+public:
+  explicit Operation(const char *name) : m_name(name), m_calls(0), m_nanoseconds(0), m_scanned(0), m_next(NULL) {
+    for (std::atomic<std::uint64_t> &bucket : m_histogram)
+      bucket.store(0, std::memory_order_relaxed);
+    m_next = s_first.load(std::memory_order_relaxed);
+    while (!s_first.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+  }
+
+  Operation(const Operation &) = delete;
+  Operation &operator=(const Operation &) = delete;
+
+  /**
+   * @return Die Stufe der Laufzeit, Stufe b enthält Laufzeiten unter 2^b ns.
+   */
+  static std::size_t bucket(std::uint64_t nanoseconds) {
+    std::size_t bucket = nanoseconds == 0 ? 0 : 64 - __builtin_clzll(nanoseconds);
+    return bucket < s_buckets ? bucket : s_buckets - 1;
+  }
+
+  void record(std::uint64_t nanoseconds) {
+    m_calls.fetch_add(1, std::memory_order_relaxed);
+    m_nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    m_histogram[bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void scanned(std::uint64_t count) { m_scanned.fetch_add(count, std::memory_order_relaxed); }
+
+  void reset() {
+    m_calls.store(0, std::memory_order_relaxed);
+    m_nanoseconds.store(0, std::memory_order_relaxed);
+    m_scanned.store(0, std::memory_order_relaxed);
+    for (std::atomic<std::uint64_t> &bucket : m_histogram)
+      bucket.store(0, std::memory_order_relaxed);
+  }
+
+  const char *name() const { return m_name; }
+  std::uint64_t calls() const { return m_calls.load(std::memory_order_relaxed); }
+  std::uint64_t nanoseconds() const { return m_nanoseconds.load(std::memory_order_relaxed); }
+  std::uint64_t scanned() const { return m_scanned.load(std::memory_order_relaxed); }
+  std::uint64_t histogram(std::size_t bucket) const { return m_histogram[bucket].load(std::memory_order_relaxed); }
+
+  /**
+   * @return Die zuerst eingetragene Operation der globalen Liste oder NULL.
+   */
+  static Operation *first() { return s_first.load(std::memory_order_acquire); }
+
+  Operation *next() const { return m_next; }
+};
+
+/**
+ * @brief Misst die Laufzeit vom Konstruktor bis zum Destruktor und trägt sie
+ * bei der Operation ein.
+ */
+class OperationTimer {
+private:
+  Operation &m_operation;
+  std::chrono::steady_clock::time_point m_start;
+
+public:
+  explicit OperationTimer(Operation &operation) : m_operation(operation), m_start(std::chrono::steady_clock::now()) {}
+
+  OperationTimer(const OperationTimer &) = delete;
+  OperationTimer &operator=(const OperationTimer &) = delete;
+
+  ~OperationTimer() {
+    m_operation.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+  }
+};
+
+/**
+ * @brief Ausgabe aller instrumentierten Operationen.
+ */
+class Instrumentation {
+public:
+  /**
+   * @return true Wenn mit CAMPUS_INSTRUMENTATION übersetzt wurde.
+   */
+  static constexpr bool enabled() {
+#if defined(CAMPUS_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * @brief Hängt eine Tabelle aller Operationen an, eine Zeile je Operation
+   * mit Aufrufen, mittlerer Laufzeit, den Stufen unter denen 50% bzw. 99% der
+   * Laufzeiten liegen und den besuchten Elementen je Aufruf.
+   */
+  static void append_to(std::string &buffer);
+
+  /**
+   * @brief Hängt alle Operationen als JSON Objekt an, die Verteilung wird als
+   * Liste der nicht leeren Stufen [b, Anzahl] ausgegeben.
+   */
+  static void append_json(std::string &buffer);
+
+  /**
+   * @brief Setzt alle Zähler zurück.
+   */
+  static void reset();
+};
+
+/*
+ * Mit CAMPUS_INSTRUMENTATION misst CAMPUS_INSTRUMENT(name) die Laufzeit des
+ * umgebenden Blocks und zählt den Aufruf, CAMPUS_SCANNED(count) zählt die
+ * dabei besuchten Elemente. Ohne das Makro wird nichts erzeugt.
+ */
+#if defined(CAMPUS_INSTRUMENTATION)
+#define CAMPUS_INSTRUMENT(name)                                                                                        \
+  static Operation campus_operation(name);                                                                             \
+  OperationTimer campus_operation_timer(campus_operation)
+#define CAMPUS_SCANNED(count) campus_operation.scanned(count)
+#else
+#define CAMPUS_INSTRUMENT(name) ((void)0)
+#define CAMPUS_SCANNED(count) ((void)0)
+#endif
@@ -0,0 +1,57 @@
+#include "interning.h"
+
+StringPool::StringPool(): m_bytes(0){}
+
+StringPool &StringPool::global()
+{
+	static StringPool pool;
+	return pool;
+}
+
+const std::string *StringPool::intern(std::string_view str)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_index.find(str);
+	if(it != m_index.end())
+		return it->second;
+
+	const std::string &stored = m_strings.emplace_back(str);
+	m_index.emplace(stored, &stored);
+	if(stored.capacity() > 15)
+		m_bytes += stored.capacity() + 1;
+	return &stored;
+}
+
+const std::string *StringPool::find(std::string_view str) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_index.find(str);
+	return it == m_index.end() ? NULL : it->second;
+}
+
+std::size_t StringPool::size() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_strings.size();
+}
+
+std::size_t StringPool::memory_usage() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::size_t node = sizeof(void *) + sizeof(std::string_view) + sizeof(const std::string *) + sizeof(std::size_t);
+	return m_bytes + m_strings.size() * (sizeof(std::string) + node)
+		+ m_index.bucket_count() * sizeof(void *);
+}
+
+static const std::string *empty_string()
+{
+	static const std::string *empty = StringPool::global().intern(std::string_view());
+	return empty;
+}
+
+InternedString::InternedString(): m_str(empty_string()){}
+
+InternedString::InternedString(std::string_view str): m_str(StringPool::global().intern(str)){}
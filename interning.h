@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief Prozessweiter Pool für häufig wiederkehrende Zeichenketten wie Namen,
+ * Städte und Länder. Jede Zeichenkette wird nur einmal gespeichert und
+ * behält ihre Adresse bis zum Programmende, gleiche Zeichenketten liefern
+ * damit immer dasselbe Objekt. Das Einfügen ist über einen Mutex geschützt,
+ * das Lesen einer bereits eingefügten Zeichenkette benötigt keine Sperre.
+ */
+class StringPool {
+private:
+  std::deque<std::string> m_strings;
+  std::unordered_map<std::string_view, const std::string *> m_index;
+  std::size_t m_bytes;
+  mutable std::mutex m_mutex;
+
+public:
+  StringPool();
+  StringPool(const StringPool &) = delete;
+  StringPool &operator=(const StringPool &) = delete;
+
+  /**
+   * @return StringPool& Der prozessweite Pool.
+   */
+  static StringPool &global();
+
+  /**
+   * @brief Sucht die Zeichenkette im Pool und fügt sie ein, falls sie noch
+   * nicht existiert.
+   *
+   * @return const std::string* Die Zeichenkette im Pool.
+   */
+  const std::string *intern(std::string_view str);
+
+  /**
+   * @brief Sucht die Zeichenkette im Pool ohne sie einzufügen.
+   *
+   * @return const std::string* Die Zeichenkette im Pool oder NULL falls sie
+   * nicht existiert.
+   */
+  const std::string *find(std::string_view str) const;
+
+  /**
+   * @return Die Anzahl verschiedener Zeichenketten im Pool.
+   */
+  std::size_t size() const;
+
+  /**
+   * @return Der ungefähre Speicherverbrauch des Pools in Bytes, inklusive der
+   * Zeichenketten und des Index.
+   */
+  std::size_t memory_usage() const;
+};
+
+/**
+ * @brief Verweis auf eine Zeichenkette im prozessweiten StringPool. Das Objekt
+ * ist so groß wie ein Zeiger, Vergleiche auf Gleichheit sind Vergleiche der
+ * Zeiger.
+ */
+class InternedString {
+private:
+  const std::string *m_str;
+
+public:
+  /**
+   * @brief Erzeugt einen Verweis auf die leere Zeichenkette.
+   */
+  InternedString();
+
+  /**
+   * @brief Erzeugt einen Verweis auf die Zeichenkette im globalen Pool und
+   * fügt sie dort ein, falls sie noch nicht existiert.
+   */
+  explicit InternedString(std::string_view str);
+
+  const std::string &str() const { return *m_str; }
+
+  operator const std::string &() const { return *m_str; }
+
+  bool operator==(const InternedString &other) const {
+    return m_str == other.m_str;
+  }
+
+  bool operator!=(const InternedString &other) const {
+    return m_str != other.m_str;
+  }
+};
@@ -0,0 +1,440 @@
+#include "journal.h"
+#include "persons.h"
+#include "university.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+/*
+ * Aufbau der Datei, alle Zahlen in der Bytereihenfolge der Maschine:
+ *
+ * char[8] magic, std::uint32_t version
+ * Gruppen aus std::uint32_t Länge, std::uint32_t Prüfsumme und den Einträgen
+ *
+ * Jeder Eintrag besteht aus dem Typ (ein Byte) und zwei Feldern first und
+ * second, beim Anlegen eines Seminars folgt der Name mit second Bytes, bei
+ * Wartelisten und Kapazitäten ein weiterer 64 Bit Wert. Ein Zeitraum trägt
+ * Beginn und Ende in den unteren und oberen 16 Bit von second.
+ */
+
+static const char s_journal_magic[8] = {'C', 'A', 'M', 'P', 'J', 'R', 'N', 'L'};
+static const std::uint32_t s_journal_version = 1;
+static const std::size_t s_journal_header = sizeof(s_journal_magic) + sizeof(std::uint32_t);
+static const std::size_t s_group_header = 2 * sizeof(std::uint32_t);
+static const std::size_t s_record_size = 1 + sizeof(std::uint32_t) + sizeof(std::int32_t);
+
+enum class JournalRecord : std::uint8_t {
+	Enroll = 1,
+	Exmatriculate,
+	Hire,
+	LayOff,
+	OfferCourse,
+	Enlist,
+	Leave,
+	AssignTeacher,
+	ResignTeacher,
+	Waitlist,
+	Capacity,
+	Slot,
+	Loan
+};
+
+/*
+ * FNV-1a über die Einträge einer Gruppe.
+ */
+static std::uint32_t journal_checksum(const char *data, std::size_t size)
+{
+	std::uint32_t hash = 2166136261u;
+	for(std::size_t i = 0; i < size; i++)
+	{
+		hash ^= static_cast<unsigned char>(data[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * Ruft die Funktion für jede vollständige Gruppe mit gültiger Prüfsumme auf
+ * und liefert das Ende der letzten solchen Gruppe.
+ */
+template <typename F> static std::size_t for_each_group(const std::string &data, F group)
+{
+	std::size_t offset = s_journal_header;
+	while(data.size() - offset >= s_group_header)
+	{
+		std::uint32_t length, checksum;
+		std::memcpy(&length, data.data() + offset, sizeof(length));
+		std::memcpy(&checksum, data.data() + offset + sizeof(length), sizeof(checksum));
+		const char *payload = data.data() + offset + s_group_header;
+		if(length > data.size() - offset - s_group_header || journal_checksum(payload, length) != checksum)
+			break;
+
+		group(payload, length);
+		offset += s_group_header + length;
+	}
+	return offset;
+}
+
+static std::string read_journal(const std::string &path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+		throw std::runtime_error("could not open journal " + path);
+
+	std::string data;
+	struct stat info;
+	if(fstat(fd, &info) == 0)
+		data.resize(info.st_size);
+
+	std::size_t done = 0;
+	while(done < data.size())
+	{
+		ssize_t count = read(fd, &data[done], data.size() - done);
+		if(count < 0 && errno == EINTR)
+			continue;
+		if(count <= 0)
+			break;
+		done += count;
+	}
+	close(fd);
+	data.resize(done);
+
+	if(data.size() < s_journal_header || std::memcmp(data.data(), s_journal_magic, sizeof(s_journal_magic)) != 0)
+		throw std::runtime_error("invalid journal " + path);
+	std::uint32_t version;
+	std::memcpy(&version, data.data() + sizeof(s_journal_magic), sizeof(version));
+	if(version != s_journal_version)
+		throw std::runtime_error("invalid journal " + path);
+	return data;
+}
+
+static void write_all(int fd, const char *data, std::size_t size)
+{
+	while(size > 0)
+	{
+		ssize_t count = write(fd, data, size);
+		if(count < 0 && errno == EINTR)
+			continue;
+		if(count < 0)
+			throw std::runtime_error("could not write journal");
+		data += count;
+		size -= count;
+	}
+}
+
+Journal::Journal(University &university, const std::string &path, std::size_t group_size):
+	m_university(university), m_fd(-1), m_group_size(group_size > 0 ? group_size : 1), m_pending(0)
+{
+	m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+	if(m_fd < 0)
+		throw std::runtime_error("could not open journal " + path);
+
+	try
+	{
+		struct stat info;
+		if(fstat(m_fd, &info) != 0)
+			throw std::runtime_error("could not open journal " + path);
+
+		if(info.st_size == 0)
+		{
+			char header[s_journal_header];
+			std::memcpy(header, s_journal_magic, sizeof(s_journal_magic));
+			std::memcpy(header + sizeof(s_journal_magic), &s_journal_version, sizeof(s_journal_version));
+			write_all(m_fd, header, sizeof(header));
+		}
+		else
+		{
+			// Eine beim Absturz unvollständig geschriebene Gruppe wird abgeschnitten,
+			// damit neue Gruppen direkt an die letzte gültige anschließen.
+			std::string data = read_journal(path);
+			std::size_t end = for_each_group(data, [](const char *, std::size_t){});
+			if(end != static_cast<std::size_t>(info.st_size) && ftruncate(m_fd, end) != 0)
+				throw std::runtime_error("could not repair journal " + path);
+		}
+		if(fdatasync(m_fd) != 0)
+			throw std::runtime_error("could not sync journal " + path);
+	}
+	catch(...)
+	{
+		close(m_fd);
+		throw;
+	}
+
+	m_university.add_listener(*this);
+}
+
+Journal::~Journal()
+{
+	m_university.remove_listener(*this);
+	try
+	{
+		flush();
+	}
+	catch(const std::runtime_error &)
+	{
+	}
+	close(m_fd);
+}
+
+void Journal::append(const char *record, std::size_t size)
+{
+	bool full;
+	{
+		std::lock_guard<std::mutex> lock(m_buffer_lock);
+		if(m_buffer.empty())
+			m_buffer.append(s_group_header, '\0');
+		m_buffer.append(record, size);
+		full = ++m_pending >= m_group_size;
+	}
+	if(full)
+		flush();
+}
+
+void Journal::write_group(const std::string &group)
+{
+	std::uint32_t length = group.size() - s_group_header;
+	std::uint32_t checksum = journal_checksum(group.data() + s_group_header, length);
+	char *header = const_cast<char *>(group.data());
+	std::memcpy(header, &length, sizeof(length));
+	std::memcpy(header + sizeof(length), &checksum, sizeof(checksum));
+
+	write_all(m_fd, group.data(), group.size());
+	if(fdatasync(m_fd) != 0)
+		throw std::runtime_error("could not sync journal");
+}
+
+void Journal::flush()
+{
+	std::lock_guard<std::mutex> write_lock(m_write_lock);
+	{
+		std::lock_guard<std::mutex> lock(m_buffer_lock);
+		if(m_buffer.empty())
+			return;
+		m_writing.swap(m_buffer);
+		m_pending = 0;
+	}
+	// Während geschrieben wird, sammeln andere Threads bereits die nächste
+	// Gruppe im anderen Puffer.
+	write_group(m_writing);
+	m_writing.clear();
+}
+
+static void encode(char *record, JournalRecord type, std::uint32_t first, std::int32_t second)
+{
+	record[0] = static_cast<char>(type);
+	std::memcpy(record + 1, &first, sizeof(first));
+	std::memcpy(record + 1 + sizeof(first), &second, sizeof(second));
+}
+
+void Journal::enrolled(const Student &student)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Enroll, student.student_number(), 0);
+	append(record, sizeof(record));
+}
+
+void Journal::exmatriculated(const Student &student)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Exmatriculate, student.student_number(), 0);
+	append(record, sizeof(record));
+}
+
+void Journal::hired(const Teacher &teacher, std::int32_t loan)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Hire, teacher.staff_number(), loan);
+	append(record, sizeof(record));
+}
+
+void Journal::laid_off(const Teacher &teacher)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::LayOff, teacher.staff_number(), 0);
+	append(record, sizeof(record));
+}
+
+void Journal::loan_changed(const Teacher &teacher, std::int32_t loan)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Loan, teacher.staff_number(), loan);
+	append(record, sizeof(record));
+}
+
+void Journal::course_offered(const Course &course)
+{
+	std::string record(s_record_size, '\0');
+	encode(&record[0], JournalRecord::OfferCourse, course.id(), course.name().size());
+	record += course.name();
+	append(record.data(), record.size());
+}
+
+void Journal::enlisted(const Course &course, const Student &student)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Enlist, course.id(), student.student_number());
+	append(record, sizeof(record));
+}
+
+void Journal::left(const Course &course, const Student &student)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Leave, course.id(), student.student_number());
+	append(record, sizeof(record));
+}
+
+void Journal::waitlisted(const Course &course, const Student &student, std::int64_t priority)
+{
+	char record[s_record_size + sizeof(priority)];
+	encode(record, JournalRecord::Waitlist, course.id(), student.student_number());
+	std::memcpy(record + s_record_size, &priority, sizeof(priority));
+	append(record, sizeof(record));
+}
+
+void Journal::left_waitlist(const Course &course, const Student &student)
+{
+	left(course, student);
+}
+
+void Journal::capacity_changed(const Course &course, std::size_t capacity)
+{
+	std::uint64_t value = capacity;
+	char record[s_record_size + sizeof(value)];
+	encode(record, JournalRecord::Capacity, course.id(), 0);
+	std::memcpy(record + s_record_size, &value, sizeof(value));
+	append(record, sizeof(record));
+}
+
+void Journal::teacher_assigned(const Course &course, const Teacher &teacher)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::AssignTeacher, course.id(), teacher.staff_number());
+	append(record, sizeof(record));
+}
+
+void Journal::teacher_resigned(const Course &course, const Teacher &teacher)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::ResignTeacher, course.id(), teacher.staff_number());
+	append(record, sizeof(record));
+}
+
+void Journal::slot_added(const Course &course, const TimeSlot &slot)
+{
+	char record[s_record_size];
+	encode(record, JournalRecord::Slot, course.id(), slot.begin | static_cast<std::int32_t>(slot.end) << 16);
+	append(record, sizeof(record));
+}
+
+std::size_t Journal::replay(const std::string &path, University &university,
+		const std::function<Student *(std::int32_t)> &find_student,
+		const std::function<Teacher *(std::int32_t)> &find_teacher)
+{
+	std::string data = read_journal(path);
+	std::unordered_map<std::uint32_t, Course *> courses;
+	std::size_t applied = 0;
+
+	auto student = [&](std::int32_t student_number) -> Student & {
+		Student *student = find_student(student_number);
+		if(student == NULL)
+			throw std::runtime_error("journal references unknown student");
+		return *student;
+	};
+	auto teacher = [&](std::int32_t staff_number) -> Teacher & {
+		Teacher *teacher = find_teacher(staff_number);
+		if(teacher == NULL)
+			throw std::runtime_error("journal references unknown teacher");
+		return *teacher;
+	};
+	auto course = [&](std::uint32_t id) -> Course & {
+		auto it = courses.find(id);
+		if(it == courses.end())
+			throw std::runtime_error("journal references unknown course");
+		return *it->second;
+	};
+
+	for_each_group(data, [&](const char *payload, std::size_t length) {
+		std::size_t offset = 0;
+		auto value = [&]() {
+			std::uint64_t value;
+			if(length - offset < sizeof(value))
+				throw std::runtime_error("invalid journal record");
+			std::memcpy(&value, payload + offset, sizeof(value));
+			offset += sizeof(value);
+			return value;
+		};
+		while(offset < length)
+		{
+			if(length - offset < s_record_size)
+				throw std::runtime_error("invalid journal record");
+
+			JournalRecord type = static_cast<JournalRecord>(payload[offset]);
+			std::uint32_t first;
+			std::int32_t second;
+			std::memcpy(&first, payload + offset + 1, sizeof(first));
+			std::memcpy(&second, payload + offset + 1 + sizeof(first), sizeof(second));
+			offset += s_record_size;
+
+			switch(type)
+			{
+			case JournalRecord::Enroll:
+				university.enroll(student(first));
+				break;
+			case JournalRecord::Exmatriculate:
+				university.exmatriculate(student(first));
+				break;
+			case JournalRecord::Hire:
+				university.hire(teacher(first), second);
+				break;
+			case JournalRecord::LayOff:
+				university.lay_off(teacher(first));
+				break;
+			case JournalRecord::OfferCourse:
+			{
+				if(second < 0 || static_cast<std::size_t>(second) > length - offset)
+					throw std::runtime_error("invalid journal record");
+				std::string name(payload + offset, second);
+				offset += second;
+
+				auto it = university.m_course_index.find(name);
+				courses[first] = it != university.m_course_index.end() ? it->second : &university.add_course(name);
+				break;
+			}
+			case JournalRecord::Enlist:
+				course(first).enlist(student(second));
+				break;
+			case JournalRecord::Leave:
+				course(first).leave(student(second));
+				break;
+			case JournalRecord::Waitlist:
+				course(first).enlist(student(second), static_cast<std::int64_t>(value()));
+				break;
+			case JournalRecord::Capacity:
+				course(first).set_capacity(value());
+				break;
+			case JournalRecord::AssignTeacher:
+				course(first).assign_teacher(teacher(second));
+				break;
+			case JournalRecord::ResignTeacher:
+				if(course(first).teacher() == &teacher(second))
+					course(first).resign_teacher();
+				break;
+			case JournalRecord::Loan:
+				teacher(first).change_loan(second);
+				break;
+			case JournalRecord::Slot:
+				course(first).add_slot(TimeSlot{static_cast<std::uint16_t>(second & 0xffff), static_cast<std::uint16_t>(second >> 16)});
+				break;
+			default:
+				throw std::runtime_error("invalid journal record");
+			}
+			applied++;
+		}
+	});
+	return applied;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "listener.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+class University;
+
+/**
+ * @brief Write-Ahead-Journal aller Veränderungen einer Universität. Das
+ * Journal meldet sich als MutationListener an der Universität an und hängt
+ * jede Veränderung als kompakten binären Eintrag an eine lokale Datei an.
+ *
+ * Die Einträge werden gesammelt und gruppenweise geschrieben (group commit):
+ * erst wenn group_size Einträge vorliegen oder flush() aufgerufen wird, wird
+ * der Puffer mit einem write und einem einzigen fdatasync auf die Platte
+ * gebracht. Mit group_size 1 wird jede Veränderung einzeln synchronisiert.
+ * Jede Gruppe trägt ihre Länge und eine Prüfsumme, eine beim Absturz nur
+ * teilweise geschriebene letzte Gruppe wird beim Wiedereinspielen verworfen.
+ *
+ * Studierende und Lehrkräfte werden über ihre Matrikel- bzw. Personalnummer
+ * referenziert, Seminare über ihre Seminarnummer zum Zeitpunkt der Aufnahme.
+ *
+ * Die Methoden sind threadsicher, das Journal kann damit auch hinter der
+ * RegistrationEngine genutzt werden. Das Journal muss vor der Universität
+ * zerstört werden.
+ */
+class Journal : public MutationListener {
+private:
+  University &m_university;
+  int m_fd;
+  std::size_t m_group_size;
+  std::size_t m_pending;
+  std::string m_buffer;
+  std::string m_writing;
+  std::mutex m_buffer_lock;
+  std::mutex m_write_lock;
+
+  void append(const char *record, std::size_t size);
+  void write_group(const std::string &group);
+
+public:
+  /**
+   * @brief Öffnet das Journal zum Anhängen und meldet es an der Universität
+   * an. Existiert die Datei noch nicht, wird sie angelegt.
+   *
+   * @throws std::runtime_error Wenn die Datei nicht geöffnet werden kann oder
+   * kein Journal ist.
+   *
+   * @param university Universität deren Veränderungen aufgezeichnet werden.
+   * @param path Pfad der Journaldatei.
+   * @param group_size Anzahl der Einträge welche gemeinsam synchronisiert
+   * werden.
+   */
+  Journal(University &university, const std::string &path, std::size_t group_size = 256);
+
+  Journal(const Journal &) = delete;
+  Journal &operator=(const Journal &) = delete;
+
+  /**
+   * @brief Meldet das Journal von der Universität ab, schreibt alle noch
+   * offenen Einträge und schließt die Datei.
+   */
+  virtual ~Journal();
+
+  /**
+   * @brief Schreibt alle gesammelten Einträge und wartet bis diese auf der
+   * Platte liegen.
+   *
+   * @throws std::runtime_error Wenn nicht geschrieben werden kann.
+   */
+  void flush();
+
+  /**
+   * @brief Spielt ein Journal auf eine Universität ein. Diese sollte leer sein
+   * und darf während des Einspielens kein Journal auf dieselbe Datei
+   * angemeldet haben. Die Personen werden über die übergebenen Funktionen
+   * anhand ihrer Nummer aufgelöst, Seminare werden neu angelegt.
+   *
+   * @throws std::runtime_error Wenn die Datei kein Journal ist oder eine
+   * Person nicht aufgelöst werden kann.
+   *
+   * @param path Pfad der Journaldatei.
+   * @param university Universität auf welche die Veränderungen angewendet
+   * werden.
+   * @param find_student Liefert den Studierenden zur Matrikelnummer oder NULL.
+   * @param find_teacher Liefert die Lehrkraft zur Personalnummer oder NULL.
+   * @return std::size_t Anzahl der eingespielten Einträge.
+   */
+  static std::size_t replay(const std::string &path, University &university,
+      const std::function<Student *(std::int32_t)> &find_student,
+      const std::function<Teacher *(std::int32_t)> &find_teacher);
+
+  void enrolled(const Student &student) override;
+  void exmatriculated(const Student &student) override;
+  void hired(const Teacher &teacher, std::int32_t loan) override;
+  void laid_off(const Teacher &teacher) override;
+  void loan_changed(const Teacher &teacher, std::int32_t loan) override;
+  void course_offered(const Course &course) override;
+  void enlisted(const Course &course, const Student &student) override;
+  void left(const Course &course, const Student &student) override;
+  void waitlisted(const Course &course, const Student &student, std::int64_t priority) override;
+  void left_waitlist(const Course &course, const Student &student) override;
+  void capacity_changed(const Course &course, std::size_t capacity) override;
+  void teacher_assigned(const Course &course, const Teacher &teacher) override;
+  void teacher_resigned(const Course &course, const Teacher &teacher) override;
+  void slot_added(const Course &course, const TimeSlot &slot) override;
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class Course;
+class Student;
+class Teacher;
+struct TimeSlot;
+
+/**
+ * @brief Beobachter welcher über alle Veränderungen an einer Universität
+ * benachrichtigt wird, unabhängig davon über welche Klasse die Veränderung
+ * angestoßen wurde. Die Benachrichtigung erfolgt nachdem die Veränderung
+ * durchgeführt wurde und nur wenn sich tatsächlich etwas verändert hat.
+ *
+ * Alle Methoden haben eine leere Standardimplementierung, abgeleitete Klassen
+ * überschreiben nur die Ereignisse welche sie interessieren. Werden die
+ * Modellklassen aus mehreren Threads verändert (z.B. über die
+ * RegistrationEngine), werden auch die Methoden parallel aufgerufen.
+ */
+class MutationListener {
+public:
+  virtual ~MutationListener() = default;
+
+  virtual void enrolled(const Student &) {}
+  virtual void exmatriculated(const Student &) {}
+  virtual void hired(const Teacher &, std::int32_t) {}
+  virtual void laid_off(const Teacher &) {}
+  virtual void loan_changed(const Teacher &, std::int32_t) {}
+  virtual void course_offered(const Course &) {}
+  virtual void enlisted(const Course &, const Student &) {}
+  virtual void left(const Course &, const Student &) {}
+  virtual void waitlisted(const Course &, const Student &, std::int64_t) {}
+  virtual void left_waitlist(const Course &, const Student &) {}
+  virtual void capacity_changed(const Course &, std::size_t) {}
+  virtual void teacher_assigned(const Course &, const Teacher &) {}
+  virtual void teacher_resigned(const Course &, const Teacher &) {}
+  virtual void slot_added(const Course &, const TimeSlot &) {}
+};
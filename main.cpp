@@ -1,20 +1,27 @@
 #include "persons.h"
 #include "traits.h"
+#include "interning.cpp"
+#include "date.cpp"
+#include "formatting.cpp"
+#include "validation.cpp"
+#include "payroll.cpp"
+#include "instrumentation.cpp"
 #include "university.cpp"
 #include "persons.cpp"
-#include <chrono>
+#include "roster.cpp"
+#include "registration.cpp"
+#include "snapshot.cpp"
+#include "journal.cpp"
+#include "statistics.cpp"
+#include "change_stream.cpp"
+#include "federation.cpp"
+#include "versioned_view.cpp"
+#include "csv_import.cpp"
 #include <cstdlib>
-#include <math.h>
 
-std::chrono::system_clock::time_point change_birthday(int years_ago)
+Date change_birthday(int years_ago)
 {
-	long double years_to_seconds = years_ago*3.154*pow(10, 7);
-	std::chrono::system_clock::time_point 
-		now = std::chrono::system_clock::now();
-	std::time_t 
-		now_t = std::chrono::system_clock::to_time_t(now) - years_to_seconds;
-		now = std::chrono::system_clock::from_time_t(now_t);
-	return now;
+	return Date::today().add_years(-years_ago);
 }
 
 int main(){
@@ -26,7 +33,7 @@ int main(){
 	Address ad6("TestStreet", 1, "12345", "Berlin", "Germany");
 	Address *p_ad3 = &ad3;
 		
-	std::chrono::system_clock::time_point date1, date2, date3, date4;
+	Date date1, date2, date3, date4;
 		
 	date1 = change_birthday(18);
 	date2 = change_birthday(26);	
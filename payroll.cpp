@@ -0,0 +1,75 @@
+#include "payroll.h"
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+PayrollSummary summarize_loans(const std::int32_t *loans, std::size_t count)
+{
+	PayrollSummary summary = {0, count, std::numeric_limits<std::int32_t>::max(),
+		std::numeric_limits<std::int32_t>::min(), {}};
+	std::size_t i = 0;
+
+#if defined(__SSE2__)
+	if(count >= 4)
+	{
+		// Die Summe wird in 64 Bit Spuren gebildet, die Gehälter werden dafür
+		// mit ihrem Vorzeichen erweitert. SSE2 kennt kein Minimum und Maximum
+		// für 32 Bit Zahlen, diese werden über einen Vergleich ausgewählt.
+		__m128i low_sum = _mm_setzero_si128();
+		__m128i high_sum = _mm_setzero_si128();
+		__m128i min = _mm_set1_epi32(summary.min);
+		__m128i max = _mm_set1_epi32(summary.max);
+		for(; i + 4 <= count; i += 4)
+		{
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(loans + i));
+			__m128i sign = _mm_srai_epi32(value, 31);
+			low_sum = _mm_add_epi64(low_sum, _mm_unpacklo_epi32(value, sign));
+			high_sum = _mm_add_epi64(high_sum, _mm_unpackhi_epi32(value, sign));
+
+			__m128i lower = _mm_cmplt_epi32(value, min);
+			min = _mm_or_si128(_mm_and_si128(lower, value), _mm_andnot_si128(lower, min));
+			__m128i higher = _mm_cmpgt_epi32(value, max);
+			max = _mm_or_si128(_mm_and_si128(higher, value), _mm_andnot_si128(higher, max));
+		}
+
+		alignas(16) std::int64_t sums[2];
+		alignas(16) std::int32_t mins[4];
+		alignas(16) std::int32_t maxs[4];
+		_mm_store_si128(reinterpret_cast<__m128i *>(sums), _mm_add_epi64(low_sum, high_sum));
+		_mm_store_si128(reinterpret_cast<__m128i *>(mins), min);
+		_mm_store_si128(reinterpret_cast<__m128i *>(maxs), max);
+		summary.total = sums[0] + sums[1];
+		for(int k = 0; k < 4; k++)
+		{
+			summary.min = std::min(summary.min, mins[k]);
+			summary.max = std::max(summary.max, maxs[k]);
+		}
+	}
+#endif
+	for(; i < count; i++)
+	{
+		summary.total += loans[i];
+		summary.min = std::min(summary.min, loans[i]);
+		summary.max = std::max(summary.max, loans[i]);
+	}
+
+	// Zwei Histogramme im Wechsel, damit aufeinanderfolgende gleiche Gehälter
+	// nicht auf dasselbe Speicherwort warten.
+	std::array<std::size_t, PayrollSummary::s_buckets> odd = {};
+	i = 0;
+	for(; i + 2 <= count; i += 2)
+	{
+		summary.histogram[PayrollSummary::bucket(loans[i])]++;
+		odd[PayrollSummary::bucket(loans[i + 1])]++;
+	}
+	if(i < count)
+		summary.histogram[PayrollSummary::bucket(loans[i])]++;
+	for(std::size_t k = 0; k < PayrollSummary::s_buckets; k++)
+		summary.histogram[k] += odd[k];
+
+	if(count == 0)
+		summary.min = summary.max = 0;
+	return summary;
+}
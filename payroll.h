@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * @brief Kennzahlen über die Gehälter der Lehrkräfte einer Universität. Die
+ * Gehälter werden in Stufen von s_bucket_width Euro ab 1000€ gezählt, die
+ * letzte Stufe enthält alle höheren Gehälter.
+ */
+struct PayrollSummary {
+  static constexpr std::size_t s_buckets = 16;
+  static constexpr std::int32_t s_bucket_width = 1000;
+
+  std::int64_t total;
+  std::size_t count;
+  std::int32_t min;
+  std::int32_t max;
+  std::array<std::size_t, s_buckets> histogram;
+
+  /**
+   * @return Die Gehaltsstufe des Gehalts.
+   */
+  static std::size_t bucket(std::int32_t loan) {
+    if (loan < 1000)
+      return 0;
+    return std::min<std::size_t>((loan - 1000) / s_bucket_width, s_buckets - 1);
+  }
+
+  /**
+   * @return Das durchschnittliche Gehalt oder 0 ohne Lehrkräfte.
+   */
+  double average() const { return count > 0 ? static_cast<double>(total) / count : 0; }
+
+  bool operator==(const PayrollSummary &other) const {
+    return total == other.total && count == other.count && min == other.min && max == other.max &&
+           histogram == other.histogram;
+  }
+
+  bool operator!=(const PayrollSummary &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Berechnet die Kennzahlen in einem Durchlauf über eine Spalte von
+ * Gehältern. Summe, Minimum und Maximum werden auf Maschinen mit SSE2 für
+ * vier Gehälter auf einmal bestimmt. Ohne Gehälter sind alle Werte 0.
+ */
+PayrollSummary summarize_loans(const std::int32_t *loans, std::size_t count);
+
+/**
+ * @brief Laufend geführte Gehaltsabrechnung einer Universität. Die Gehälter
+ * liegen als Spalte in derselben Reihenfolge wie University::list_teachers(),
+ * Summe, Anzahl und Gehaltsstufen werden bei jeder Anstellung, Entlassung und
+ * Gehaltsänderung in O(1) nachgeführt. Für Minimum und Maximum wird die Anzahl
+ * je Gehalt in einem Suchbaum gezählt, die Änderung kostet damit O(log d) bei d
+ * verschiedenen Gehältern und die Abfrage O(1).
+ *
+ * Mit verify() lassen sich die laufenden Kennzahlen gegen eine vollständige
+ * Neuberechnung über die Spalte prüfen.
+ */
+class Payroll {
+private:
+  std::vector<std::int32_t> m_loans;
+  std::map<std::int32_t, std::size_t> m_distinct;
+  std::int64_t m_total;
+  std::array<std::size_t, PayrollSummary::s_buckets> m_histogram;
+
+  void add(std::int32_t loan) {
+    m_total += loan;
+    m_histogram[PayrollSummary::bucket(loan)]++;
+    m_distinct[loan]++;
+  }
+
+  void remove(std::int32_t loan) {
+    m_total -= loan;
+    m_histogram[PayrollSummary::bucket(loan)]--;
+    auto it = m_distinct.find(loan);
+    if (--it->second == 0)
+      m_distinct.erase(it);
+  }
+
+public:
+  Payroll() : m_total(0), m_histogram() {}
+
+  /**
+   * @brief Reserviert die Spalte für mindestens count Gehälter.
+   */
+  void reserve(std::size_t count) { m_loans.reserve(count); }
+
+  /**
+   * @brief Hängt das Gehalt einer neu angestellten Lehrkraft an.
+   */
+  void push_back(std::int32_t loan) {
+    m_loans.emplace_back(loan);
+    add(loan);
+  }
+
+  /**
+   * @brief Entfernt das Gehalt an der Position, indem das letzte an seine
+   * Stelle verschoben wird. Dies entspricht dem Entfernen aus der Registry der
+   * Universität.
+   */
+  void erase(std::size_t pos) {
+    remove(m_loans[pos]);
+    m_loans[pos] = m_loans.back();
+    m_loans.pop_back();
+  }
+
+  /**
+   * @brief Ändert das Gehalt an der Position.
+   */
+  void set(std::size_t pos, std::int32_t loan) {
+    remove(m_loans[pos]);
+    m_loans[pos] = loan;
+    add(loan);
+  }
+
+  /**
+   * @return Die laufend geführten Kennzahlen.
+   */
+  PayrollSummary summary() const {
+    PayrollSummary summary = {m_total, m_loans.size(), 0, 0, m_histogram};
+    if (!m_distinct.empty()) {
+      summary.min = m_distinct.begin()->first;
+      summary.max = m_distinct.rbegin()->first;
+    }
+    return summary;
+  }
+
+  /**
+   * @return true Wenn die laufenden Kennzahlen mit einer Neuberechnung über
+   * die Spalte übereinstimmen.
+   */
+  bool verify() const { return summarize_loans(m_loans.data(), m_loans.size()) == summary(); }
+
+  /**
+   * @return Die Gehälter in der Reihenfolge von University::list_teachers().
+   */
+  const std::vector<std::int32_t> &loans() const { return m_loans; }
+
+  std::size_t size() const { return m_loans.size(); }
+};
@@ -0,0 +1,142 @@
+#pragma once
+#include "interning.h"
+#include "persons.h"
+#include "registry.h"
+#include "university.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+inline std::int32_t person_number(Student &student) { return student.student_number(); }
+inline std::int32_t person_number(Teacher &teacher) { return teacher.staff_number(); }
+
+/**
+ * @brief Suchindizes über die Studierenden oder Lehrkräfte einer Universität.
+ * Die Universität hält die Indizes bei jeder Immatrikulation bzw. Anstellung,
+ * beim Verlassen und bei jedem Umzug aktuell.
+ *
+ * Vor- und Nachnamen liegen sortiert in je einem Suchbaum, eine Suche nach
+ * einem Präfix springt damit in O(log n) an den ersten Treffer. Die Städte
+ * werden über die Adresse ihrer Zeichenkette im StringPool gehasht, die
+ * Geburtstage liegen sortiert für Bereichsabfragen. Gleiche Schlüssel werden
+ * über die Matrikel- bzw. Personalnummer unterschieden, Treffer kommen damit
+ * in einer festen Reihenfolge.
+ */
+template <typename T> class PersonIndex {
+private:
+  std::map<std::pair<std::string_view, std::int32_t>, T *> m_last_names;
+  std::map<std::pair<std::string_view, std::int32_t>, T *> m_first_names;
+  std::map<std::pair<Date, std::int32_t>, T *> m_birthdays;
+  std::unordered_map<const std::string *, Registry<std::int32_t, T>> m_cities;
+
+  static std::vector<T *> prefix_range(const std::map<std::pair<std::string_view, std::int32_t>, T *> &names,
+                                       std::string_view prefix, std::size_t limit) {
+    std::vector<T *> result;
+    auto it = names.lower_bound(std::make_pair(prefix, std::numeric_limits<std::int32_t>::min()));
+    for (; it != names.end() && result.size() < limit; it++) {
+      if (it->first.first.substr(0, prefix.size()) != prefix)
+        break;
+      result.emplace_back(it->second);
+    }
+    return result;
+  }
+
+  void insert_city(T &person, const Address &address) {
+    m_cities[&address.city()].insert(person_number(person), &person);
+  }
+
+  void erase_city(T &person, const Address &address) {
+    auto it = m_cities.find(&address.city());
+    if (it == m_cities.end())
+      return;
+    it->second.erase(person_number(person));
+    if (it->second.empty())
+      m_cities.erase(it);
+  }
+
+public:
+  /**
+   * @brief Nimmt die Person in alle Indizes auf.
+   */
+  void insert(T &person) {
+    std::int32_t number = person_number(person);
+    m_last_names.emplace(std::make_pair(std::string_view(person.last_name()), number), &person);
+    m_first_names.emplace(std::make_pair(std::string_view(person.first_name()), number), &person);
+    m_birthdays.emplace(std::make_pair(person.birthday(), number), &person);
+    insert_city(person, person.place_of_residence());
+  }
+
+  /**
+   * @brief Entfernt die Person aus allen Indizes.
+   */
+  void erase(T &person) {
+    std::int32_t number = person_number(person);
+    m_last_names.erase(std::make_pair(std::string_view(person.last_name()), number));
+    m_first_names.erase(std::make_pair(std::string_view(person.first_name()), number));
+    m_birthdays.erase(std::make_pair(person.birthday(), number));
+    erase_city(person, person.place_of_residence());
+  }
+
+  /**
+   * @brief Trägt die Person nach einem Umzug unter ihrer neuen Stadt ein.
+   *
+   * @param previous Der Wohnort vor dem Umzug.
+   */
+  void relocate(T &person, const Address &previous) {
+    erase_city(person, previous);
+    insert_city(person, person.place_of_residence());
+  }
+
+  /**
+   * @return Höchstens limit Personen deren Nachname mit dem Präfix beginnt,
+   * aufsteigend nach Nachnamen sortiert.
+   */
+  std::vector<T *> by_last_name(std::string_view prefix,
+                                std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+    return prefix_range(m_last_names, prefix, limit);
+  }
+
+  /**
+   * @return Höchstens limit Personen deren Vorname mit dem Präfix beginnt,
+   * aufsteigend nach Vornamen sortiert.
+   */
+  std::vector<T *> by_first_name(std::string_view prefix,
+                                 std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+    return prefix_range(m_first_names, prefix, limit);
+  }
+
+  /**
+   * @return Alle Personen welche in der Stadt wohnen.
+   */
+  std::vector<T *> by_city(std::string_view city) const {
+    const std::string *interned = StringPool::global().find(city);
+    if (interned == NULL)
+      return std::vector<T *>();
+    auto it = m_cities.find(interned);
+    return it == m_cities.end() ? std::vector<T *>() : it->second.items();
+  }
+
+  /**
+   * @return Höchstens limit Personen mit einem Geburtstag im Bereich
+   * [from, to), aufsteigend nach Geburtstag sortiert.
+   */
+  std::vector<T *> by_birthday(Date from, Date to,
+                               std::size_t limit = std::numeric_limits<std::size_t>::max()) const {
+    std::vector<T *> result;
+    auto it = m_birthdays.lower_bound(std::make_pair(from, std::numeric_limits<std::int32_t>::min()));
+    for (; it != m_birthdays.end() && it->first.first < to && result.size() < limit; it++)
+      result.emplace_back(it->second);
+    return result;
+  }
+
+  /**
+   * @return Die Anzahl der Personen in den Indizes.
+   */
+  std::size_t size() const { return m_birthdays.size(); }
+};
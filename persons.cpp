@@ -1,27 +1,25 @@
 #include "persons.h"
+#include "formatting.h"
+#include "instrumentation.h"
 #include "traits.h"
 #include "university.h"
-#include <chrono>
 #include <stdexcept>
-#include <sstream>
 #include <iostream>
 #include <string>
 
-Person::Person(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence) : Displayable()
+Person::Person(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence) : Displayable()
 {
-	std::chrono::system_clock::time_point now = std::chrono::system_clock::now();
-	
 	if(first_name.length()>=2 && !(digits_exist(first_name))){
-		m_first_name = first_name;
+		m_first_name = InternedString(first_name);
 	}	
 	else throw std::domain_error("invalid first name");
 
 	if(last_name.length()>=2 && !(digits_exist(last_name))){
-		m_last_name = last_name;
+		m_last_name = InternedString(last_name);
 	}
 	else throw std::domain_error("invalid last name");
 	
-	if(birthday < now){
+	if(birthday <= Date::today()){
 		m_birthday = birthday;
 	} else throw std::domain_error("impossible birthday");
 
@@ -29,73 +27,78 @@ Person::Person(std::string first_name, std::string last_name, std::chrono::syste
 	
 }
 
+Person::Person(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, Prevalidated):
+	Displayable(), m_first_name(first_name), m_last_name(last_name), m_birthday(birthday),
+	m_place_of_residence(&place_of_residence){}
+
 void Person::relocate(Address &place_of_residence)
 {
+	CAMPUS_INSTRUMENT("Person::relocate");
 	m_place_of_residence = &place_of_residence;
 }
 
-std::string Person::to_string() const 
+void Person::append_to(std::string &buffer) const
 {
-	std::stringstream strstream;
-	std::string str,
-		address_str = m_place_of_residence->to_string();
-	std::time_t birthday_t = std::chrono::system_clock::to_time_t(m_birthday);
-
-	strstream << "\n" << m_first_name << " " << m_last_name << "\n";
-	strstream << std::ctime(&birthday_t) << "\n";
-	strstream << address_str;
-
-	str = strstream.str();
-	return str;
+	append_all(buffer, {"\n", m_first_name.str(), " ", m_last_name.str(), "\n"});
+	append_date(buffer, m_birthday);
+	buffer += '\n';
+	m_place_of_residence->append_to(buffer);
 }
 
-int32_t Student::s_student_counter = 0;
+std::atomic<std::int32_t> Student::s_student_counter(0);
 
-Student::Student(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence): 
-	Person(first_name, last_name, birthday, place_of_residence),
+Student::Student(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence): 
+	Person(std::move(first_name), std::move(last_name), birthday, place_of_residence),
 	m_student_number(++s_student_counter){
 	m_university = NULL;
 }
 
-Student::~Student(){}
+Student::Student(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, std::int32_t student_number, Prevalidated):
+	Person(first_name, last_name, birthday, place_of_residence, Prevalidated()),
+	m_student_number(student_number){
+	m_university = NULL;
+	reserve_numbers(student_number);
+}
+
+void Student::reserve_numbers(std::int32_t last_number)
+{
+	std::int32_t current = s_student_counter.load();
+	while(current < last_number && !s_student_counter.compare_exchange_weak(current, last_number));
+}
+
+Student::~Student()
+{
+	while(!m_courses.empty())
+		m_courses.back()->leave(*this);
+	while(!m_waitlists.empty())
+		m_waitlists.items().back()->leave(*this);
+	exmatriculate();
+}
 
 Student::Student(Person &person): Person(person), m_student_number(++s_student_counter){
 	m_university = NULL;
 }
 
-void Student::enlist(Course &course)
+void Student::enlist(Course &course, std::int64_t priority)
 {
-	bool repeated = false;
-		
-	for(const auto& ptr: m_courses)
-	{
-		if(course.name() == ptr->name())
-			repeated = true;
-	}		
-
-	if(!repeated){
-		m_courses.emplace_back(&course);
-		course.enlist(*this);
-	}
+	CAMPUS_INSTRUMENT("Student::enlist");
+	course.enlist(*this, priority);
 }
 
 void Student::leave(Course &course)
 {
-	int pos = 0;
-	for( const auto& ptr : m_courses )	
-	{
-		if(course.name() == ptr->name())
-		{
-			m_courses.erase(m_courses.begin()+pos);
-			course.leave(*this);
-			break;
-		}
-		pos++;
-	}
+	CAMPUS_INSTRUMENT("Student::leave");
+	course.leave(*this);
+}
+
+bool Student::is_enlisted(const Course &course) const
+{
+	return course.is_enlisted(*this);
 }
 
 void Student::enroll(University &university)
 {
+	CAMPUS_INSTRUMENT("Student::enroll");
 	if(m_university == NULL)
 	{
 		m_university = &university;
@@ -109,80 +112,92 @@ void Student::enroll(University &university)
 
 void Student::exmatriculate()
 {
+	CAMPUS_INSTRUMENT("Student::exmatriculate");
 	if(m_university != NULL){
 		m_university->exmatriculate(*this);
 		m_university = NULL;
 	}
 }
 
-std::string Student::to_string() const
+void Student::relocate(Address &place_of_residence)
 {
-	std::stringstream strstream;
-	strstream << Person::to_string() << "\n";
-	strstream << "Universität: " << m_university->name() << "\n\n";
-	strstream << "Matrikelnummer: " << m_student_number << "\n\n";
-	strstream << "Anzahl Seminare: " << m_courses.size() << "\n";
-	for(auto i = 0; i<m_courses.size(); i++)
-	{
-		strstream << i + 1 << " " << m_courses[i]->name() << "\n";
-	}
+	CAMPUS_INSTRUMENT("Student::relocate");
+	const Address &previous = *m_place_of_residence;
+	Person::relocate(place_of_residence);
+	if(m_university != NULL)
+		m_university->relocated(*this, previous);
+}
 
+void Student::append_to(std::string &buffer) const
+{
+	Person::append_to(buffer);
+	buffer += "\nUniversität: ";
+	if(m_university != NULL)
+		buffer += m_university->name();
+	buffer += "\n\nMatrikelnummer: ";
+	append_number(buffer, m_student_number);
+	buffer += "\n\nAnzahl Seminare: ";
 
-	return strstream.str();
+	append_number(buffer, m_courses.size());
+	buffer += '\n';
+	std::size_t i = 0;
+	for(Course *course : m_courses)
+		append_roster_line(buffer, ++i, course->name());
 }
 
-Teacher::Teacher(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence):
-	Person(first_name, last_name, birthday, place_of_residence){
+std::atomic<std::int32_t> Teacher::s_staff_counter(0);
+
+Teacher::Teacher(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence):
+	Person(std::move(first_name), std::move(last_name), birthday, place_of_residence),
+	m_staff_number(++s_staff_counter){
 	m_loan = 0;
 	m_university = NULL;
 }
 
-Teacher::Teacher(Person &person): Person(person){ m_loan = 0; m_university = NULL;}
+Teacher::Teacher(Person &person): Person(person), m_staff_number(++s_staff_counter){ m_loan = 0; m_university = NULL;}
 
-Teacher::~Teacher(){}
+Teacher::Teacher(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, std::int32_t staff_number, Prevalidated):
+	Person(first_name, last_name, birthday, place_of_residence, Prevalidated()),
+	m_staff_number(staff_number){
+	m_loan = 0;
+	m_university = NULL;
+	reserve_numbers(staff_number);
+}
 
-void Teacher::assign_course(Course &course)
+void Teacher::reserve_numbers(std::int32_t last_number)
 {
-	bool repeated = false;
-		
-	for(const auto& ptr: m_courses)
-	{
-		if(course.name() == ptr->name())
-		{
-			repeated = true;
-			break;
-		}
-	}		
+	std::int32_t current = s_staff_counter.load();
+	while(current < last_number && !s_staff_counter.compare_exchange_weak(current, last_number));
+}
 
-	if(!repeated){
-		m_courses.emplace_back(&course);
-		course.assign_teacher(*this);
-	}
+Teacher::~Teacher()
+{
+	while(!m_courses.empty())
+		m_courses.back()->resign_teacher();
+	lay_off();
 }
 
-void Teacher::resign_course(Course &course)
+void Teacher::assign_course(Course &course)
 {
-	int pos = 0;
-	bool found = false;
-	for(const auto& ptr: m_courses)
-	{
-		if(course.name() == ptr->name())
-		{
-			found = true;
-			break;	
-		}
-		pos++;
-	}
+	CAMPUS_INSTRUMENT("Teacher::assign_course");
+	course.assign_teacher(*this);
+}
 
-	if(found){
-		m_courses.erase(m_courses.begin()+pos);
+void Teacher::resign_course(Course &course)
+{
+	CAMPUS_INSTRUMENT("Teacher::resign_course");
+	if(teaches(course))
 		course.resign_teacher();
-	}
-	
+}
+
+bool Teacher::teaches(const Course &course) const
+{
+	return course.teacher() == this;
 }
 
 void Teacher::lay_off()
 {
+	CAMPUS_INSTRUMENT("Teacher::lay_off");
 	if(m_university != NULL)
 	{
 		m_loan = 0;
@@ -191,27 +206,58 @@ void Teacher::lay_off()
 	}
 }
 
+void Teacher::change_loan(std::int32_t loan)
+{
+	CAMPUS_INSTRUMENT("Teacher::change_loan");
+	if(loan < 1000)
+		throw std::domain_error("Salary too low");
+	if(m_university != NULL && m_loan != loan)
+	{
+		m_loan = loan;
+		m_university->loan_changed(*this);
+	}
+}
+
 void Teacher::hire(University &university, std::int32_t loan)
 {
+	CAMPUS_INSTRUMENT("Teacher::hire");
 	if(loan >= 1000)
 	{
+		if(m_university == &university)
+		{
+			change_loan(loan);
+			return;
+		}
+		if(m_university != NULL)
+			lay_off();
 		m_university = &university;
 		m_loan = loan;
 		university.hire(*this, loan);
 	} else throw std::domain_error("Salary too low");
 }
 
-std::string Teacher::to_string() const
+void Teacher::relocate(Address &place_of_residence)
 {
-	std::stringstream strstream;
+	CAMPUS_INSTRUMENT("Teacher::relocate");
+	const Address &previous = *m_place_of_residence;
+	Person::relocate(place_of_residence);
+	if(m_university != NULL)
+		m_university->relocated(*this, previous);
+}
 
-	strstream << Person::to_string() << "\n"
-		<< "Universität: " << m_university->name() << "\n"
-		<< "Gehalt: " << m_loan << "€\n\n"
-		<< "Anzahl Seminare: " << m_courses.size() << "\n";
-	for(int i = 0; i < m_courses.size(); i++)
-		{
-			strstream << i +1 << " " << m_courses[i]->name() << "\n";
-		}
-	return strstream.str();
+void Teacher::append_to(std::string &buffer) const
+{
+	Person::append_to(buffer);
+	buffer += "\nUniversität: ";
+	if(m_university != NULL)
+		buffer += m_university->name();
+	buffer += "\nGehalt: ";
+	append_number(buffer, m_loan);
+	buffer += "€\n\nAnzahl Seminare: ";
+
+	append_number(buffer, m_courses.size());
+	buffer += '\n';
+	std::size_t i = 0;
+	for(Course *course : m_courses)
+		append_roster_line(buffer, ++i, course->name());
 }
@@ -1,8 +1,15 @@
 #pragma once
 #include "traits.h"
+#include "course_set.h"
+#include "enrollment.h"
+#include "date.h"
+#include "interning.h"
+#include "schedule.h"
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <string>
+#include <string_view>
 #include <vector>
 
 class University;
@@ -17,13 +24,13 @@ class Course;
  * Verfügung stehen (4).
  *
  * Die Klasse erbt die von der abstrakten Klasse Display die Spezifikation der
- * to_string Methode welche implementiert werden muss. (3)
+ * append_to Methode welche implementiert werden muss. (3)
  */
 class Person : public Displayable {
 protected:
-  std::string m_first_name;
-  std::string m_last_name;
-  std::chrono::system_clock::time_point m_birthday;
+  InternedString m_first_name;
+  InternedString m_last_name;
+  Date m_birthday;
   Address *m_place_of_residence;
 
 public:
@@ -43,70 +50,84 @@ public:
    */
   // TODO Konstruktor welcher das Address Objekt initialisiert und dabei die
   // Daten validiert.
-  Person(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence);
+  Person(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence);
+
+  /**
+   * @brief Erzeugt das Personen Objekt aus bereits geprüften Daten, ohne diese
+   * erneut zu validieren.
+   */
+  Person(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, Prevalidated);
   /**
    * @brief Lässt die Person an einen anderen Ort umziehen.
    *
    * @param place_of_residence der Ort zu dem die Person zieht.
    */
-  void relocate(Address &place_of_residence);
+  virtual void relocate(Address &place_of_residence);
 
   /**
-   * @return Der Vorname der Person
+   * @return Der Vorname der Person. Gleiche Vornamen liefern dieselbe Referenz
+   * aus dem StringPool.
    */
-  const std::string &first_name(){return m_first_name;}
+  const std::string &first_name() const{return m_first_name;}
 
   /**
-   * @return Der Nachname der Person
+   * @return Der Nachname der Person. Gleiche Nachnamen liefern dieselbe
+   * Referenz aus dem StringPool.
    */
-  const std::string &last_name(){return m_last_name;}
+  const std::string &last_name() const{return m_last_name;}
 
   /**
    * @return Der Wohnort der Person
    */
-  const Address &place_of_residence(){ return *m_place_of_residence; }
+  const Address &place_of_residence() const{ return *m_place_of_residence; }
 
   /**
    * @return Der Geburtstag der Person
    */
-  const std::chrono::system_clock::time_point birthday()
-  {return m_birthday;}
+  Date birthday() const{return m_birthday;}
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Das Format soll in dieser Form erfolgen, die Trennung
-   * erfolgt mit einem Zeilenumbruch am Ende der Zeile:
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Das
+   * Format soll in dieser Form erfolgen, die Trennung erfolgt mit einem
+   * Zeilenumbruch am Ende der Zeile:
    *
    * Vorname Nachname
    * Geburtsdatum
    *
-   * Address::to_string
+   * Address::append_to
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
 
 /**
  * @brief Stellt einen Studiernden einer Universität dar und erbt alle Methoden
  * und Daten der Person Klasse (3) und erweitert diese um Spezifische Daten und
- * Verhalten z.B. die to_string Methode welche schon in der Person Klasse
+ * Verhalten z.B. die append_to Methode welche schon in der Person Klasse
  * implementiert wurde.
  *
  */
 class Student : public Person {
+  friend class Course;
+  friend class University;
+
 private:
   const std::int32_t m_student_number;
   University *m_university;
-  std::vector<Course *> m_courses;
+  EnrollmentList<Student, EnrollmentSide::member> m_courses;
+  CourseSet m_waitlists;
+  Schedule m_schedule;
 
   /**
    * @brief Zähler mit stastischer Lebensdauer der alle erstellten
    * Studentenobjekte zählt, die Matrikelnummer ergibt sich aus der aktuellen
-   * Zahl + 1.
+   * Zahl + 1. Der Zähler ist atomar, womit Studierende auch parallel aus
+   * mehreren Threads erzeugt werden können.
    */
-  static std::int32_t s_student_counter;
+  static std::atomic<std::int32_t> s_student_counter;
 
 public:
   /**
@@ -127,7 +148,14 @@ public:
    */
   // TODO Constructor welcher das Studentobjekt initialisiert und bei der
   // Erstellung den Zähler inkrementiert.
-  Student(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence);
+  Student(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence);
+
+  /**
+   * @brief Stellt einen Studierenden mit seiner bisherigen Matrikelnummer aus
+   * bereits geprüften Daten wieder her. Der Zähler wird so weit erhöht, dass
+   * neue Studierende keine vergebene Nummer erhalten.
+   */
+  Student(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, std::int32_t student_number, Prevalidated);
   /**
    * @brief Kopierkonstruktor welcher die Daten eines Personen Objekts übernimmt
    * und das Studentenobjekt übernimmt. Die Zähler muss ganz regulär
@@ -139,24 +167,49 @@ public:
 
   /**
    * @brief Destruktor des Studierenden Objekts. Dieser trägt den Studierenden
-   * aus allen Seminaren aus und exmatrikuliert diesen wenn er an einer
+   * aus allen Seminaren und Wartelisten aus und exmatrikuliert diesen wenn er an einer
    * Universität immatrikuliert ist. Diese Veränderung wird auch allen Seminaren
    * und der Universität mitgeteilt.
    */
   virtual ~Student();
 
+  /**
+   * @brief Stellt sicher, dass alle neu vergebenen Matrikelnummern größer als
+   * last_number sind.
+   */
+  static void reserve_numbers(std::int32_t last_number);
+
+  /**
+   * @brief Vergibt count aufeinanderfolgende Matrikelnummern auf einmal, z.B.
+   * für einen Import in Dateireihenfolge.
+   *
+   * @return Die erste der vergebenen Nummern.
+   */
+  static std::int32_t allocate_numbers(std::int32_t count){ return s_student_counter.fetch_add(count) + 1; }
+
+  /**
+   * @return Die zuletzt vergebene Matrikelnummer.
+   */
+  static std::int32_t last_number(){ return s_student_counter.load(); }
+
   /**
    * @brief Schreibt den Studierenden in das Seminar ein, falls dieser nicht
    * schon eingeschrieben ist. Das Seminar wird über die Einschreibung ebenfalls
-   * benachrichtigt.
+   * benachrichtigt. Ist das Seminar voll, kommt der Studierende auf dessen
+   * Warteliste (siehe Course::enlist).
+   *
+   * @throws std::domain_error Wenn sich das Seminar mit dem Wochenplan des
+   * Studierenden überschneidet.
    *
    * @param course Das Seminar in welches der Studierende eingeschrieben wird
+   * @param priority Rang auf der Warteliste, kleinere Werte rücken zuerst nach.
    */
-  void enlist(Course &course);
+  void enlist(Course &course, std::int64_t priority = 0);
 
   /**
-   * @brief Trägt den Studierenden aus dem Seminar aus falls dieser eingetragen
-   * ist. Das Seminar wird ebenfalls über diese Änderung benachrichtigt.
+   * @brief Trägt den Studierenden aus dem Seminar oder dessen Warteliste aus
+   * falls dieser eingetragen ist. Das Seminar wird ebenfalls über diese
+   * Änderung benachrichtigt.
    *
    * @param course Kurs aus dem der Studierende ausgetragen werden soll
    */
@@ -181,26 +234,56 @@ public:
   void exmatriculate();
 
   /**
-   * @return std::vector<Course&> Alle Seminare in die der Studierenden
-   * eingeschrieben ist.
+   * @brief Lässt den Studierenden umziehen und teilt dies der Universität mit,
+   * an welcher er immatrikuliert ist.
+   *
+   * @param place_of_residence der Ort zu dem der Studierende zieht.
    */
-	std::vector<Course *> &list_courses(){
+  void relocate(Address &place_of_residence) override;
+
+  /**
+   * @return Alle Seminare in die der Studierenden eingeschrieben ist, in der
+   * Reihenfolge der Einschreibung.
+   */
+	const EnrollmentList<Student, EnrollmentSide::member> &list_courses() const{
 		return m_courses;
 	};
 
+  /**
+   * @return true Wenn der Studierende in das Seminar eingeschrieben ist.
+   */
+  bool is_enlisted(const Course &course) const;
+
+  /**
+   * @return std::vector<Course*>& Alle Seminare auf deren Warteliste der
+   * Studierende steht.
+   */
+	std::vector<Course *> &list_waitlists(){
+		return m_waitlists.items();
+	}
+
+  /**
+   * @return Der Wochenplan aus den Zeiträumen aller Seminare in die der
+   * Studierende eingeschrieben ist.
+   */
+  const Schedule &schedule() const{
+    return m_schedule;
+  }
+
   /*
    * @return University Die Universität in die der Studierende eingeschrieben
    * ist.
    */
   University *university(){ return m_university; };
 
-  const std::int32_t student_number(){return m_student_number;}
+  const std::int32_t student_number() const{return m_student_number;}
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Das Format ist folgendes:
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Das
+   * Format ist folgendes:
    *
-   * Person::to_string
+   * Person::append_to
    *
    * Universität: University::name
    *
@@ -209,24 +292,36 @@ public:
    * Anzahl Seminare: xxx
    * Course::name (Für jedes Seminar)
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
 
 /**
  * @brief Stellt eine Lehrkraft an einer Universität dar und erbt alle Methoden
  * und Daten der Person Klasse (3) und erweitert diese um Spezifische Daten und
- * Verhalten z.B. die to_string Methode welche schon in der Person Klasse
+ * Verhalten z.B. die append_to Methode welche schon in der Person Klasse
  * implementiert wurde.
  */
 class Teacher : public Person {
+  friend class Course;
+  friend class University;
+
 private:
+  const std::int32_t m_staff_number;
   std::int32_t m_loan;
-  std::vector<Course *> m_courses;
+  EnrollmentList<Teacher, EnrollmentSide::member> m_courses;
+  Schedule m_schedule;
   University *m_university;
 
+  /**
+   * @brief Zähler mit stastischer Lebensdauer der alle erstellten
+   * Lehrkraftobjekte zählt, die Personalnummer ergibt sich aus der aktuellen
+   * Zahl + 1. Der Zähler ist atomar.
+   */
+  static std::atomic<std::int32_t> s_staff_counter;
+
 public:
   /**
    * Konstruktor welcher ein neues Lehrkraft Objekt erzeugt, in dem der
@@ -244,7 +339,14 @@ public:
    * @param address Wohnort der Person.
    */
   // TODO Konstruktor welcher das Lehrkraftobjekt initialisiert
-  Teacher(std::string first_name, std::string last_name, std::chrono::system_clock::time_point birthday, Address &place_of_residence);
+  Teacher(std::string first_name, std::string last_name, Date birthday, Address &place_of_residence);
+
+  /**
+   * @brief Stellt eine Lehrkraft mit ihrer bisherigen Personalnummer aus
+   * bereits geprüften Daten wieder her. Der Zähler wird so weit erhöht, dass
+   * neue Lehrkräfte keine vergebene Nummer erhalten.
+   */
+  Teacher(std::string_view first_name, std::string_view last_name, Date birthday, Address &place_of_residence, std::int32_t staff_number, Prevalidated);
 
   /**
    * @brief Kopierkonstruktor welcher die Daten eines Personen Objekts
@@ -262,10 +364,36 @@ public:
    */
   virtual ~Teacher();
 
+  /**
+   * @brief Stellt sicher, dass alle neu vergebenen Personalnummern größer als
+   * last_number sind.
+   */
+  static void reserve_numbers(std::int32_t last_number);
+
+  /**
+   * @brief Vergibt count aufeinanderfolgende Personalnummern auf einmal.
+   *
+   * @return Die erste der vergebenen Nummern.
+   */
+  static std::int32_t allocate_numbers(std::int32_t count){ return s_staff_counter.fetch_add(count) + 1; }
+
+  /**
+   * @return Die zuletzt vergebene Personalnummer.
+   */
+  static std::int32_t last_number(){ return s_staff_counter.load(); }
+
+  /**
+   * @return Das Gehalt der Lehrkraft, 0 falls sie nicht angestellt ist.
+   */
+  std::int32_t loan() const{ return m_loan; }
+
   /**
    * @brief Weist der Lehrkraft das Seminar zu, falls dies nicht schon geschehen
    * ist. Das Seminar wird ebenfalls darüber informiert.
    *
+   * @throws std::domain_error Wenn sich das Seminar mit dem Wochenplan der
+   * Lehrkraft überschneidet.
+   *
    * @param course Das Seminar welches der Lehrkraft zu gewiesen wird
    */
   void assign_course(Course &course);
@@ -282,7 +410,8 @@ public:
    * @brief Stellt eine neue Lehrkraft an der Universität an. Falls diese schon
    * an einer anderen Universität angestellt ist kündigt die Lehrkraft an dieser
    * Universität. Die Universitäten bekommen diese Veränderung ebenfalls
-   * mitgeteilt.
+   * mitgeteilt. Ist sie bereits an dieser Universität angestellt, wird nur
+   * das Gehalt geändert (siehe change_loan).
    *
    * @throws std::domain_error Wenn das Gehalt weniger als 1000€ beträgt.
    *
@@ -298,12 +427,44 @@ public:
   void lay_off();
 
   /**
-   * @return std::vector<Course&> Alle Seminare welche die Lehrkraft hält.
+   * @brief Ändert das Gehalt der angestellten Lehrkraft und teilt dies der
+   * Universität mit. Ist die Lehrkraft nicht angestellt, passiert nichts.
+   *
+   * @throws std::domain_error Wenn das Gehalt weniger als 1000€ beträgt.
+   *
+   * @param loan Das neue Gehalt, mindestens 1000€.
+   */
+  void change_loan(std::int32_t loan);
+
+  /**
+   * @brief Lässt die Lehrkraft umziehen und teilt dies der Universität mit, an
+   * welcher sie angestellt ist.
+   *
+   * @param place_of_residence der Ort zu dem die Lehrkraft zieht.
+   */
+  void relocate(Address &place_of_residence) override;
+
+  /**
+   * @return Alle Seminare welche die Lehrkraft hält, in der Reihenfolge der
+   * Zuweisung.
    */
-	std::vector<Course *> &list_courses(){
+	const EnrollmentList<Teacher, EnrollmentSide::member> &list_courses() const{
 		return m_courses;
 	};
 
+  /**
+   * @return true Wenn die Lehrkraft das Seminar hält.
+   */
+  bool teaches(const Course &course) const;
+
+  /**
+   * @return Der Wochenplan aus den Zeiträumen aller Seminare welche die
+   * Lehrkraft hält.
+   */
+  const Schedule &schedule() const{
+    return m_schedule;
+  }
+
   /*
    * @return University Die Universität an der die Lehrkraft arbeitet.
    */
@@ -312,10 +473,16 @@ public:
 	}
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Das Format ist folgendes:
+   * @return Die Personalnummer welche die Lehrkraft eindeutig identifiziert.
+   */
+  std::int32_t staff_number() const{return m_staff_number;}
+
+  /**
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Das
+   * Format ist folgendes:
    *
-   * Person::to_string
+   * Person::append_to
    *
    * Universität: University::name
    * Gehalt: xxx
@@ -323,8 +490,8 @@ public:
    * Anzahl Seminare: xxx
    * Course::name (Für jedes Seminar)
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
@@ -0,0 +1,89 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Speicherpool für Objekte mit stabiler Adresse. Die Objekte werden in
+ * zusammenhängenden Blöcken angelegt, deren Größe sich bis zu einer Obergrenze
+ * mit jedem neuen Block verdoppelt. Das Anlegen kostet damit amortisiert O(1)
+ * und benötigt nur wenige Speicheranforderungen, einmal angelegte Objekte
+ * werden nie verschoben.
+ *
+ * Einzelne Objekte können nicht freigegeben werden, alle Objekte werden
+ * gemeinsam mit clear() oder im Destruktor des Pools zerstört.
+ */
+template <typename T> class Pool {
+private:
+  struct Block {
+    T *data;
+    std::size_t capacity;
+  };
+
+  static constexpr std::size_t s_first_block = 16;
+  static constexpr std::size_t s_max_block = 65536;
+
+  std::vector<Block> m_blocks;
+  std::size_t m_used;
+  std::size_t m_size;
+
+public:
+  Pool() : m_used(0), m_size(0) {}
+  Pool(const Pool &) = delete;
+  Pool &operator=(const Pool &) = delete;
+
+  ~Pool() { clear(); }
+
+  /**
+   * @brief Legt ein neues Objekt im Pool an, die Argumente werden an den
+   * Konstruktor von T weitergereicht. Wirft der Konstruktor, bleibt der Pool
+   * unverändert.
+   *
+   * @return T* Das neue Objekt, dessen Adresse bis zum clear() gültig bleibt.
+   */
+  template <typename... Args> T *create(Args &&...args) {
+    if (m_blocks.empty() || m_used == m_blocks.back().capacity) {
+      std::size_t capacity =
+          m_blocks.empty() ? s_first_block
+                           : std::min(m_blocks.back().capacity * 2, s_max_block);
+      T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+      m_blocks.push_back(Block{data, capacity});
+      m_used = 0;
+    }
+
+    T *item = m_blocks.back().data + m_used;
+    new (item) T(std::forward<Args>(args)...);
+    m_used++;
+    m_size++;
+    return item;
+  }
+
+  /**
+   * @brief Zerstört alle Objekte in umgekehrter Reihenfolge ihrer Erstellung
+   * und gibt den Speicher aller Blöcke frei.
+   */
+  void clear() {
+    for (std::size_t b = m_blocks.size(); b > 0; b--) {
+      Block &block = m_blocks[b - 1];
+      std::size_t used = b == m_blocks.size() ? m_used : block.capacity;
+      for (std::size_t i = used; i > 0; i--)
+        block.data[i - 1].~T();
+      ::operator delete(block.data);
+    }
+    m_blocks.clear();
+    m_used = 0;
+    m_size = 0;
+  }
+
+  /**
+   * @return Die Anzahl der Objekte im Pool.
+   */
+  std::size_t size() const { return m_size; }
+
+  /**
+   * @return Die Anzahl der Speicherblöcke welche der Pool angefordert hat.
+   */
+  std::size_t blocks() const { return m_blocks.size(); }
+};
@@ -0,0 +1,81 @@
+#include "registration.h"
+#include "persons.h"
+#include "university.h"
+#include <thread>
+
+RegistrationEngine::RegistrationEngine(University &university): m_university(university){}
+
+std::mutex &RegistrationEngine::student_lock(Student &student)
+{
+	return m_student_locks[static_cast<std::uint32_t>(student.student_number()) % s_stripes];
+}
+
+std::mutex &RegistrationEngine::course_lock(const Course &course)
+{
+	return m_course_locks[course.id() % s_stripes];
+}
+
+void RegistrationEngine::enroll(Student &student)
+{
+	std::unique_lock<std::shared_mutex> membership(m_membership_lock);
+	std::lock_guard<std::mutex> lock(student_lock(student));
+	m_university.enroll(student);
+}
+
+void RegistrationEngine::exmatriculate(Student &student)
+{
+	std::unique_lock<std::shared_mutex> membership(m_membership_lock);
+	std::lock_guard<std::mutex> lock(student_lock(student));
+	m_university.exmatriculate(student);
+}
+
+bool RegistrationEngine::is_enrolled(std::int32_t student_number)
+{
+	std::shared_lock<std::shared_mutex> membership(m_membership_lock);
+	return m_university.find_student(student_number) != NULL;
+}
+
+void RegistrationEngine::enlist(Student &student, Course &course)
+{
+	std::lock_guard<std::mutex> student_guard(student_lock(student));
+	std::lock_guard<std::mutex> course_guard(course_lock(course));
+	student.enlist(course);
+}
+
+void RegistrationEngine::leave(Student &student, Course &course)
+{
+	std::mutex &student_mutex = student_lock(student);
+	std::mutex &course_mutex = course_lock(course);
+
+	for(;;)
+	{
+		{
+			std::lock_guard<std::mutex> student_guard(student_mutex);
+			std::lock_guard<std::mutex> course_guard(course_mutex);
+
+			if(!student.is_enlisted(course) || course.waitlist().empty())
+			{
+				student.leave(course);
+				return;
+			}
+
+			// Der frei werdende Platz geht an den ersten Wartenden, dessen Daten
+			// ebenfalls verändert werden. Seine Sperre liegt in der Reihenfolge
+			// nach der des Seminars und wird deshalb nur versucht, schlägt dies
+			// fehl werden beide Sperren freigegeben und es wird erneut versucht.
+			std::mutex &next_mutex = student_lock(*course.waitlist().front().item);
+			if(&next_mutex == &student_mutex)
+			{
+				student.leave(course);
+				return;
+			}
+			if(next_mutex.try_lock())
+			{
+				std::lock_guard<std::mutex> next_guard(next_mutex, std::adopt_lock);
+				student.leave(course);
+				return;
+			}
+		}
+		std::this_thread::yield();
+	}
+}
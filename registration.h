@@ -0,0 +1,73 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+class Course;
+class Student;
+class University;
+
+/**
+ * @brief Threadsichere Schnittstelle für Immatrikulationen und
+ * Seminareinschreibungen an einer Universität. Die Methoden der Modellklassen
+ * selbst sind nicht threadsicher, die Engine serialisiert deshalb nur die
+ * Zugriffe welche sich tatsächlich dieselben Daten teilen.
+ *
+ * Studierende und Seminare werden über ihre Matrikel- bzw. Seminarnummer auf
+ * eine feste Anzahl von Sperren verteilt (lock striping). Eine Einschreibung
+ * sperrt immer zuerst die Sperre des Studierenden und danach die des Seminars,
+ * da keine Methode diese Reihenfolge umkehrt können keine Verklemmungen
+ * entstehen. Rückt beim Austragen ein Studierender von der Warteliste nach,
+ * wird dessen Sperre nur versucht und bei Misserfolg von vorne begonnen. Die
+ * Mitgliedschaft an der Universität ist über eine Lese- und Schreibsperre
+ * geschützt, Abfragen laufen damit parallel.
+ *
+ * Solange die Engine genutzt wird, dürfen die betroffenen Objekte nicht an
+ * ihr vorbei verändert werden.
+ */
+class RegistrationEngine {
+private:
+  static constexpr std::size_t s_stripes = 64;
+
+  University &m_university;
+  std::array<std::mutex, s_stripes> m_student_locks;
+  std::array<std::mutex, s_stripes> m_course_locks;
+  std::shared_mutex m_membership_lock;
+
+  std::mutex &student_lock(Student &student);
+  std::mutex &course_lock(const Course &course);
+
+public:
+  explicit RegistrationEngine(University &university);
+  RegistrationEngine(const RegistrationEngine &) = delete;
+  RegistrationEngine &operator=(const RegistrationEngine &) = delete;
+
+  /**
+   * @brief Immatrikuliert den Studierenden an der Universität der Engine.
+   */
+  void enroll(Student &student);
+
+  /**
+   * @brief Exmatrikuliert den Studierenden falls er an der Universität der
+   * Engine immatrikuliert ist.
+   */
+  void exmatriculate(Student &student);
+
+  /**
+   * @return true Wenn der Studierende an der Universität der Engine
+   * immatrikuliert ist.
+   */
+  bool is_enrolled(std::int32_t student_number);
+
+  /**
+   * @brief Schreibt den Studierenden in das Seminar ein.
+   */
+  void enlist(Student &student, Course &course);
+
+  /**
+   * @brief Trägt den Studierenden aus dem Seminar aus.
+   */
+  void leave(Student &student, Course &course);
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Indexiertes Verzeichnis von Objekten welche über einen eindeutigen
+ * Schlüssel (z.B. die Matrikelnummer) gefunden werden. Die Objekte liegen
+ * zusammenhängend in einem Vektor, welcher über items() unverändert nach außen
+ * gegeben werden kann. Eine Hashtabelle bildet den Schlüssel auf die Position
+ * im Vektor ab.
+ *
+ * Einfügen, Suchen und Entfernen kosten damit O(1). Beim Entfernen wird das
+ * letzte Element an die frei gewordene Stelle verschoben (swap and pop),
+ * weshalb sich die Reihenfolge der Elemente dabei ändern kann.
+ */
+template <typename Key, typename T> class Registry {
+private:
+  std::vector<T *> m_items;
+  std::vector<Key> m_keys;
+  std::unordered_map<Key, std::size_t> m_index;
+
+public:
+  /**
+   * @brief Fügt das Objekt unter dem Schlüssel ein, falls dieser noch nicht
+   * vergeben ist.
+   *
+   * @return true Wenn das Objekt eingefügt wurde.
+   */
+  bool insert(const Key &key, T *item) {
+    auto result = m_index.emplace(key, m_items.size());
+    if (!result.second)
+      return false;
+    m_items.emplace_back(item);
+    m_keys.emplace_back(key);
+    return true;
+  }
+
+  /**
+   * @brief Entfernt das Objekt mit dem Schlüssel, falls es existiert.
+   *
+   * @return true Wenn ein Objekt entfernt wurde.
+   */
+  bool erase(const Key &key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+      return false;
+
+    std::size_t pos = it->second;
+    std::size_t last = m_items.size() - 1;
+    if (pos != last) {
+      m_items[pos] = m_items[last];
+      m_keys[pos] = m_keys[last];
+      m_index[m_keys[pos]] = pos;
+    }
+    m_items.pop_back();
+    m_keys.pop_back();
+    m_index.erase(it);
+    return true;
+  }
+
+  /**
+   * @return Das Objekt mit dem Schlüssel oder NULL falls es nicht existiert.
+   */
+  T *find(const Key &key) const {
+    auto it = m_index.find(key);
+    return it == m_index.end() ? NULL : m_items[it->second];
+  }
+
+  /**
+   * @return Die Position des Objekts in items() oder size() falls der
+   * Schlüssel nicht existiert.
+   */
+  std::size_t position(const Key &key) const {
+    auto it = m_index.find(key);
+    return it == m_index.end() ? m_items.size() : it->second;
+  }
+
+  bool contains(const Key &key) const { return m_index.count(key) != 0; }
+
+  /**
+   * @brief Reserviert Speicher für mindestens count Objekte.
+   */
+  void reserve(std::size_t count) {
+    m_items.reserve(count);
+    m_keys.reserve(count);
+    m_index.reserve(count);
+  }
+
+  std::size_t size() const { return m_items.size(); }
+
+  bool empty() const { return m_items.empty(); }
+
+  /**
+   * @return std::vector<T*>& Alle Objekte in der aktuellen Reihenfolge.
+   */
+  std::vector<T *> &items() { return m_items; }
+  const std::vector<T *> &items() const { return m_items; }
+};
@@ -0,0 +1,110 @@
+#include "roster.h"
+#include "persons.h"
+#include "university.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+StudentColumns::StudentColumns(): m_unused_name_bytes(0){}
+
+std::uint32_t StudentColumns::residence_id(const Address &address)
+{
+	auto result = m_address_ids.emplace(&address, m_addresses.size());
+	if(result.second)
+		m_addresses.emplace_back(&address);
+	return result.first->second;
+}
+
+void StudentColumns::push_back(Student &student)
+{
+	const std::string &first_name = student.first_name();
+	const std::string &last_name = student.last_name();
+	if(first_name.size() > std::numeric_limits<std::uint16_t>::max()
+		|| last_name.size() > std::numeric_limits<std::uint16_t>::max())
+		throw std::length_error("name too long for student columns");
+
+	m_student_numbers.emplace_back(student.student_number());
+	m_birthdays.emplace_back(student.birthday().days());
+	m_birthday_keys.emplace_back(student.birthday().anniversary_key());
+	m_name_offsets.emplace_back(m_names.size());
+	m_first_name_lengths.emplace_back(first_name.size());
+	m_last_name_lengths.emplace_back(last_name.size());
+	m_residences.emplace_back(residence_id(student.place_of_residence()));
+
+	m_names += first_name;
+	m_names += last_name;
+}
+
+void StudentColumns::erase(std::size_t pos)
+{
+	std::size_t last = size() - 1;
+	m_unused_name_bytes += m_first_name_lengths[pos] + m_last_name_lengths[pos];
+
+	m_student_numbers[pos] = m_student_numbers[last];
+	m_birthdays[pos] = m_birthdays[last];
+	m_birthday_keys[pos] = m_birthday_keys[last];
+	m_name_offsets[pos] = m_name_offsets[last];
+	m_first_name_lengths[pos] = m_first_name_lengths[last];
+	m_last_name_lengths[pos] = m_last_name_lengths[last];
+	m_residences[pos] = m_residences[last];
+
+	m_student_numbers.pop_back();
+	m_birthdays.pop_back();
+	m_birthday_keys.pop_back();
+	m_name_offsets.pop_back();
+	m_first_name_lengths.pop_back();
+	m_last_name_lengths.pop_back();
+	m_residences.pop_back();
+
+	if(m_unused_name_bytes > m_names.size() / 2)
+		compact_names();
+}
+
+void StudentColumns::relocate(std::size_t pos, const Address &address)
+{
+	m_residences[pos] = residence_id(address);
+}
+
+void StudentColumns::compact_names()
+{
+	std::string names;
+	names.reserve(m_names.size() - m_unused_name_bytes);
+	for(std::size_t i = 0; i < size(); i++)
+	{
+		std::uint32_t offset = names.size();
+		names.append(m_names, m_name_offsets[i], m_first_name_lengths[i] + m_last_name_lengths[i]);
+		m_name_offsets[i] = offset;
+	}
+	m_names.swap(names);
+	m_unused_name_bytes = 0;
+}
+
+std::map<std::int32_t, std::size_t> StudentColumns::count_per_birth_year() const
+{
+	std::map<std::int32_t, std::size_t> result;
+	if(m_birthdays.empty())
+		return result;
+
+	auto range = std::minmax_element(m_birthdays.begin(), m_birthdays.end());
+	std::int32_t first_year = Date(*range.first).year();
+	std::int32_t last_year = Date(*range.second).year();
+
+	std::vector<std::size_t> counts(last_year - first_year + 1);
+	for(std::int32_t days : m_birthdays)
+		counts[Date(days).year() - first_year]++;
+
+	for(std::size_t i = 0; i < counts.size(); i++)
+		if(counts[i] != 0)
+			result.emplace(first_year + static_cast<std::int32_t>(i), counts[i]);
+	return result;
+}
+
+std::vector<std::size_t> StudentColumns::count_age_brackets(Date today, const std::vector<std::int32_t> &ages) const
+{
+	return ::count_age_brackets(m_birthdays.data(), m_birthdays.size(), today, ages);
+}
+
+std::size_t StudentColumns::count_birthdays_between(Date from, Date to) const
+{
+	return ::count_birthdays_between(m_birthday_keys.data(), m_birthday_keys.size(), from, to);
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "date.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class Address;
+class Student;
+
+/**
+ * @brief Spaltenorientierte Kopie der Studierendendaten einer Universität für
+ * Auswertungen. Jede Eigenschaft liegt in einem eigenen zusammenhängenden
+ * Vektor, die Zeile i beschreibt dabei immer den Studierenden an Position i von
+ * University::list_students(). Die Namen liegen hintereinander in einem
+ * gemeinsamen Zeichenpuffer, die Wohnorte werden als fortlaufende Nummern
+ * gespeichert.
+ *
+ * Auswertungen wie "Studierende pro Geburtsjahr" laufen damit linear über den
+ * Speicher, ohne die einzelnen Studierendenobjekte anzufassen. Die Universität
+ * hält die Spalten bei enroll, exmatriculate und Student::relocate aktuell.
+ */
+class StudentColumns {
+private:
+  std::vector<std::int32_t> m_student_numbers;
+  std::vector<std::int32_t> m_birthdays;
+  std::vector<std::uint16_t> m_birthday_keys;
+  std::vector<std::uint32_t> m_name_offsets;
+  std::vector<std::uint16_t> m_first_name_lengths;
+  std::vector<std::uint16_t> m_last_name_lengths;
+  std::vector<std::uint32_t> m_residences;
+
+  std::string m_names;
+  std::size_t m_unused_name_bytes;
+
+  std::vector<const Address *> m_addresses;
+  std::unordered_map<const Address *, std::uint32_t> m_address_ids;
+
+  std::uint32_t residence_id(const Address &address);
+  void compact_names();
+
+public:
+  StudentColumns();
+
+  /**
+   * @brief Hängt eine Zeile für den Studierenden am Ende an.
+   */
+  void push_back(Student &student);
+
+  /**
+   * @brief Entfernt die Zeile an der Position, indem die letzte Zeile an ihre
+   * Stelle verschoben wird. Dies entspricht dem Entfernen aus der Registry der
+   * Universität.
+   */
+  void erase(std::size_t pos);
+
+  /**
+   * @brief Aktualisiert den Wohnort der Zeile an der Position.
+   */
+  void relocate(std::size_t pos, const Address &address);
+
+  std::size_t size() const { return m_student_numbers.size(); }
+
+  /**
+   * @return Die Spalte der Matrikelnummern.
+   */
+  const std::vector<std::int32_t> &student_numbers() const {
+    return m_student_numbers;
+  }
+
+  /**
+   * @return Die Spalte der Geburtstage als Date::days().
+   */
+  const std::vector<std::int32_t> &birthdays() const { return m_birthdays; }
+
+  /**
+   * @return Die Spalte der Geburtstage als Date::anniversary_key().
+   */
+  const std::vector<std::uint16_t> &birthday_keys() const { return m_birthday_keys; }
+
+  /**
+   * @return Die Spalte der Wohnorte als Nummern, siehe address().
+   */
+  const std::vector<std::uint32_t> &residences() const { return m_residences; }
+
+  /**
+   * @return Die Adresse welche zu der Wohnortnummer gehört.
+   */
+  const Address &address(std::uint32_t residence) const {
+    return *m_addresses[residence];
+  }
+
+  std::string_view first_name(std::size_t pos) const {
+    return std::string_view(m_names).substr(m_name_offsets[pos],
+                                            m_first_name_lengths[pos]);
+  }
+
+  std::string_view last_name(std::size_t pos) const {
+    return std::string_view(m_names).substr(
+        m_name_offsets[pos] + m_first_name_lengths[pos],
+        m_last_name_lengths[pos]);
+  }
+
+  /**
+   * @return Die Anzahl der Studierenden je Geburtsjahr.
+   */
+  std::map<std::int32_t, std::size_t> count_per_birth_year() const;
+
+  /**
+   * @brief Zählt die Studierenden je Altersstufe am Tag today, siehe
+   * ::count_age_brackets().
+   */
+  std::vector<std::size_t> count_age_brackets(Date today, const std::vector<std::int32_t> &ages) const;
+
+  /**
+   * @return Die Anzahl der Studierenden mit Geburtstag im Zeitraum [from, to],
+   * siehe ::count_birthdays_between().
+   */
+  std::size_t count_birthdays_between(Date from, Date to) const;
+};
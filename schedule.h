@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+class Course;
+class Person;
+
+/**
+ * @brief Wöchentlich wiederkehrender Zeitraum eines Seminars in Minuten seit
+ * Montag 0:00 Uhr. Der Zeitraum umfasst [begin, end).
+ */
+struct TimeSlot {
+  static constexpr std::uint16_t s_minutes_per_week = 7 * 24 * 60;
+
+  std::uint16_t begin;
+  std::uint16_t end;
+
+  /**
+   * @brief Erzeugt einen Zeitraum innerhalb eines Wochentags.
+   *
+   * @throws std::domain_error Wenn der Wochentag nicht zwischen 0 (Montag) und
+   * 6 liegt oder der Zeitraum leer ist oder über den Tag hinausgeht.
+   *
+   * @param weekday Wochentag, 0 für Montag.
+   * @param begin_minute Beginn in Minuten seit Mitternacht.
+   * @param end_minute Ende in Minuten seit Mitternacht.
+   */
+  static TimeSlot weekly(int weekday, int begin_minute, int end_minute) {
+    if (weekday < 0 || weekday > 6 || begin_minute < 0 || end_minute > 24 * 60 || begin_minute >= end_minute)
+      throw std::domain_error("invalid time slot");
+    std::uint16_t day = static_cast<std::uint16_t>(weekday * 24 * 60);
+    return TimeSlot{static_cast<std::uint16_t>(day + begin_minute), static_cast<std::uint16_t>(day + end_minute)};
+  }
+
+  bool overlaps(const TimeSlot &other) const { return begin < other.end && other.begin < end; }
+};
+
+/**
+ * @brief Wochenplan einer Person aus den Zeiträumen ihrer Seminare. Die
+ * Zeiträume liegen nach Beginn sortiert in einem Vektor, ein zweiter Vektor
+ * hält für jede Position den Zeitraum mit dem spätesten Ende bis dorthin.
+ * Ob sich ein neuer Zeitraum mit einem vorhandenen überschneidet, ergibt sich
+ * damit aus einer binären Suche nach dem letzten Zeitraum welcher vor dem
+ * Ende des neuen beginnt, die Prüfung kostet O(log k).
+ *
+ * Der Plan darf selbst Überschneidungen enthalten, z.B. wenn einem Seminar
+ * nachträglich ein Zeitraum hinzugefügt wird.
+ */
+class Schedule {
+public:
+  struct Entry {
+    TimeSlot slot;
+    Course *course;
+  };
+
+private:
+  std::vector<Entry> m_entries;
+  std::vector<std::uint32_t> m_latest_end;
+
+  void rebuild(std::size_t from) {
+    m_latest_end.resize(m_entries.size());
+    for (std::size_t i = from; i < m_entries.size(); i++) {
+      m_latest_end[i] = static_cast<std::uint32_t>(i);
+      if (i > 0 && m_entries[m_latest_end[i - 1]].slot.end > m_entries[i].slot.end)
+        m_latest_end[i] = m_latest_end[i - 1];
+    }
+  }
+
+public:
+  /**
+   * @return Course* Ein Seminar dessen Zeitraum sich mit dem übergebenen
+   * überschneidet oder NULL.
+   */
+  Course *conflict(const TimeSlot &slot) const {
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), slot.end,
+                               [](const Entry &entry, std::uint16_t end) { return entry.slot.begin < end; });
+    if (it == m_entries.begin())
+      return NULL;
+    const Entry &latest = m_entries[m_latest_end[it - m_entries.begin() - 1]];
+    return latest.slot.end > slot.begin ? latest.course : NULL;
+  }
+
+  /**
+   * @return Course* Ein Seminar welches sich mit einem der Zeiträume
+   * überschneidet oder NULL.
+   */
+  Course *conflict(const std::vector<TimeSlot> &slots) const {
+    for (const TimeSlot &slot : slots) {
+      if (Course *course = conflict(slot))
+        return course;
+    }
+    return NULL;
+  }
+
+  void insert(const TimeSlot &slot, Course *course) {
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), slot.begin,
+                               [](std::uint16_t begin, const Entry &entry) { return begin < entry.slot.begin; });
+    std::size_t pos = it - m_entries.begin();
+    m_entries.insert(it, Entry{slot, course});
+    rebuild(pos);
+  }
+
+  void insert(const std::vector<TimeSlot> &slots, Course *course) {
+    for (const TimeSlot &slot : slots)
+      insert(slot, course);
+  }
+
+  /**
+   * @brief Entfernt alle Zeiträume des Seminars.
+   */
+  void erase(Course *course) {
+    auto it = std::remove_if(m_entries.begin(), m_entries.end(),
+                             [course](const Entry &entry) { return entry.course == course; });
+    if (it == m_entries.end())
+      return;
+    m_entries.erase(it, m_entries.end());
+    rebuild(0);
+  }
+
+  /**
+   * @brief Ruft die Funktion für jedes Paar sich überschneidender Zeiträume
+   * verschiedener Seminare auf, sortiert nach dem Beginn des ersten Zeitraums.
+   */
+  template <typename F> void for_each_conflict(F conflict) const {
+    for (std::size_t i = 0; i < m_entries.size(); i++) {
+      for (std::size_t k = i + 1; k < m_entries.size() && m_entries[k].slot.begin < m_entries[i].slot.end; k++) {
+        if (m_entries[k].course != m_entries[i].course)
+          conflict(m_entries[i], m_entries[k]);
+      }
+    }
+  }
+
+  /**
+   * @return Alle Zeiträume nach Beginn sortiert.
+   */
+  const std::vector<Entry> &entries() const { return m_entries; }
+
+  bool empty() const { return m_entries.empty(); }
+};
+
+/**
+ * @brief Überschneidung zweier Seminare im Wochenplan einer Person.
+ */
+struct ScheduleConflict {
+  Person *person;
+  Course *first;
+  Course *second;
+  TimeSlot overlap;
+};
@@ -0,0 +1,453 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+/*
+ * Aufbau der Datei, alle Zahlen in der Bytereihenfolge der Maschine:
+ *
+ * SnapshotHeader
+ * SnapshotAddress[addresses]
+ * SnapshotStudent[students]
+ * SnapshotTeacher[teachers]
+ * SnapshotCourse[courses]
+ * SnapshotWaiting[waiting]      Wartelisten der Seminare in Nachrückreihenfolge
+ * std::uint32_t[enlistments]    Studierendenindizes der Seminare
+ * SnapshotSlot[slots]           Zeiträume der Seminare
+ * char[strings]                 Zeichenkettentabelle
+ *
+ * Die Abschnitte sind absteigend nach der Ausrichtung ihrer Elemente
+ * angeordnet, damit diese auch in der eingeblendeten Datei ausgerichtet
+ * liegen. Adressen, Studierende und Lehrkräfte sind auf ein Vielfaches von 8
+ * Bytes aufgefüllt und können deshalb vor den Seminaren stehen.
+ */
+
+static const char s_snapshot_magic[8] = {'C', 'A', 'M', 'P', 'S', 'N', 'A', 'P'};
+static const std::uint32_t s_snapshot_version = 4;
+static const std::uint32_t s_no_index = 0xffffffff;
+
+struct SnapshotString {
+	std::uint32_t offset;
+	std::uint32_t length;
+};
+
+struct SnapshotHeader {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t university_address;
+	SnapshotString university_name;
+	std::int32_t last_student_number;
+	std::int32_t last_staff_number;
+	std::uint64_t addresses;
+	std::uint64_t students;
+	std::uint64_t teachers;
+	std::uint64_t courses;
+	std::uint64_t enlistments;
+	std::uint64_t waiting;
+	std::uint64_t slots;
+	std::uint64_t strings;
+};
+
+struct SnapshotAddress {
+	SnapshotString street;
+	SnapshotString zipcode;
+	SnapshotString city;
+	SnapshotString country;
+	std::int32_t street_no;
+	std::uint32_t padding;
+};
+
+struct SnapshotStudent {
+	SnapshotString first_name;
+	SnapshotString last_name;
+	std::int32_t birthday;
+	std::uint32_t address;
+	std::int32_t student_number;
+	std::uint32_t enrolled;
+};
+
+struct SnapshotTeacher {
+	SnapshotString first_name;
+	SnapshotString last_name;
+	std::int32_t birthday;
+	std::uint32_t address;
+	std::int32_t staff_number;
+	std::int32_t loan;
+	std::uint32_t hired;
+	std::uint32_t padding;
+};
+
+static_assert(sizeof(SnapshotAddress) % 8 == 0 && sizeof(SnapshotStudent) % 8 == 0
+	&& sizeof(SnapshotTeacher) % 8 == 0, "sections before the courses keep them aligned");
+
+struct SnapshotCourse {
+	SnapshotString name;
+	std::uint32_t teacher;
+	std::uint32_t first_student;
+	std::uint32_t student_count;
+	std::uint32_t first_waiting;
+	std::uint32_t waiting_count;
+	std::uint32_t first_slot;
+	std::uint32_t slot_count;
+	std::uint32_t padding;
+	std::uint64_t capacity;
+};
+
+struct SnapshotWaiting {
+	std::uint32_t student;
+	std::uint32_t padding;
+	std::int64_t priority;
+};
+
+struct SnapshotSlot {
+	std::uint16_t begin;
+	std::uint16_t end;
+};
+
+/*
+ * Sammelt beim Schreiben die Zeichenketten, gleiche Zeichenketten aus dem
+ * StringPool werden nur einmal abgelegt.
+ */
+class SnapshotStrings {
+private:
+	std::string m_data;
+	std::unordered_map<const std::string *, SnapshotString> m_offsets;
+
+public:
+	SnapshotString add(const std::string &str)
+	{
+		auto it = m_offsets.find(&str);
+		if(it != m_offsets.end())
+			return it->second;
+
+		SnapshotString ref = {static_cast<std::uint32_t>(m_data.size()), static_cast<std::uint32_t>(str.size())};
+		m_data += str;
+		m_offsets.emplace(&str, ref);
+		return ref;
+	}
+
+	const std::string &data() const { return m_data; }
+};
+
+template <typename T> static void write_section(std::FILE *file, const std::vector<T> &section)
+{
+	if(!section.empty() && std::fwrite(section.data(), sizeof(T), section.size(), file) != section.size())
+		throw std::runtime_error("could not write snapshot");
+}
+
+Snapshot::Snapshot(){}
+
+void Snapshot::save(University &university, const std::string &path)
+{
+	SnapshotStrings strings;
+	std::vector<SnapshotAddress> addresses;
+	std::vector<SnapshotStudent> students;
+	std::vector<SnapshotTeacher> teachers;
+	std::vector<SnapshotCourse> courses;
+	std::vector<std::uint32_t> enlistments;
+	std::vector<SnapshotWaiting> waiting;
+	std::vector<SnapshotSlot> slots;
+
+	std::unordered_map<const Address *, std::uint32_t> address_index;
+	std::unordered_map<Student *, std::uint32_t> student_index;
+	std::unordered_map<Teacher *, std::uint32_t> teacher_index;
+
+	auto add_address = [&](const Address &address) {
+		auto result = address_index.emplace(&address, addresses.size());
+		if(result.second)
+		{
+			SnapshotAddress record = {strings.add(address.street()), strings.add(address.zip_code()),
+				strings.add(address.city()), strings.add(address.country()), address.street_no(), 0};
+			addresses.emplace_back(record);
+		}
+		return result.first->second;
+	};
+	auto add_student = [&](Student &student) {
+		auto result = student_index.emplace(&student, students.size());
+		if(result.second)
+		{
+			SnapshotStudent record = {strings.add(student.first_name()), strings.add(student.last_name()),
+				student.birthday().days(), add_address(student.place_of_residence()),
+				student.student_number(), student.university() == &university};
+			students.emplace_back(record);
+		}
+		return result.first->second;
+	};
+	auto add_teacher = [&](Teacher &teacher) {
+		auto result = teacher_index.emplace(&teacher, teachers.size());
+		if(result.second)
+		{
+			bool hired = teacher.university() == &university;
+			SnapshotTeacher record = {strings.add(teacher.first_name()), strings.add(teacher.last_name()),
+				teacher.birthday().days(), add_address(teacher.place_of_residence()),
+				teacher.staff_number(), hired ? teacher.loan() : 0, hired, 0};
+			teachers.emplace_back(record);
+		}
+		return result.first->second;
+	};
+
+	SnapshotHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, s_snapshot_magic, sizeof(header.magic));
+	header.version = s_snapshot_version;
+	header.university_address = add_address(university.m_address);
+	header.university_name = strings.add(university.name());
+	header.last_student_number = Student::last_number();
+	header.last_staff_number = Teacher::last_number();
+
+	for(Student *student : university.list_students())
+		add_student(*student);
+	for(Teacher *teacher : university.list_teachers())
+		add_teacher(*teacher);
+
+	for(Course *course : university.list_courses())
+	{
+		SnapshotCourse record = {strings.add(course->name()),
+			course->teacher() != NULL ? add_teacher(*course->teacher()) : s_no_index,
+			static_cast<std::uint32_t>(enlistments.size()),
+			static_cast<std::uint32_t>(course->list_students().size()),
+			static_cast<std::uint32_t>(waiting.size()),
+			static_cast<std::uint32_t>(course->waitlist().size()),
+			static_cast<std::uint32_t>(slots.size()),
+			static_cast<std::uint32_t>(course->slots().size()), 0, course->capacity()};
+		for(Student *student : course->list_students())
+			enlistments.emplace_back(add_student(*student));
+		for(const Waitlist<std::int32_t, Student>::Entry &entry : course->waitlist().entries())
+			waiting.emplace_back(SnapshotWaiting{add_student(*entry.item), 0, entry.priority});
+		for(const TimeSlot &slot : course->slots())
+			slots.emplace_back(SnapshotSlot{slot.begin, slot.end});
+		courses.emplace_back(record);
+	}
+
+	header.addresses = addresses.size();
+	header.students = students.size();
+	header.teachers = teachers.size();
+	header.courses = courses.size();
+	header.enlistments = enlistments.size();
+	header.waiting = waiting.size();
+	header.slots = slots.size();
+	header.strings = strings.data().size();
+
+	std::FILE *file = std::fopen(path.c_str(), "wb");
+	if(file == NULL)
+		throw std::runtime_error("could not open snapshot " + path);
+	try
+	{
+		if(std::fwrite(&header, sizeof(header), 1, file) != 1)
+			throw std::runtime_error("could not write snapshot");
+		write_section(file, addresses);
+		write_section(file, students);
+		write_section(file, teachers);
+		write_section(file, courses);
+		write_section(file, waiting);
+		write_section(file, enlistments);
+		write_section(file, slots);
+		if(std::fwrite(strings.data().data(), 1, strings.data().size(), file) != strings.data().size())
+			throw std::runtime_error("could not write snapshot");
+	}
+	catch(...)
+	{
+		std::fclose(file);
+		throw;
+	}
+	if(std::fclose(file) != 0)
+		throw std::runtime_error("could not write snapshot");
+}
+
+/*
+ * Eingeblendete Snapshot Datei, die Einblendung wird im Destruktor entfernt.
+ */
+class MappedSnapshot {
+private:
+	const char *m_data;
+	std::size_t m_size;
+	std::size_t m_offset;
+
+public:
+	explicit MappedSnapshot(const std::string &path): m_data(NULL), m_size(0), m_offset(0)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if(fd < 0)
+			throw std::runtime_error("could not open snapshot " + path);
+
+		struct stat info;
+		if(fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader)))
+		{
+			close(fd);
+			throw std::runtime_error("invalid snapshot " + path);
+		}
+
+		m_size = info.st_size;
+		void *data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(data == MAP_FAILED)
+			throw std::runtime_error("could not map snapshot " + path);
+		m_data = static_cast<const char *>(data);
+	}
+
+	MappedSnapshot(const MappedSnapshot &) = delete;
+	MappedSnapshot &operator=(const MappedSnapshot &) = delete;
+
+	~MappedSnapshot()
+	{
+		munmap(const_cast<char *>(m_data), m_size);
+	}
+
+	/*
+	 * Liefert die nächsten count Elemente vom Typ T und prüft dabei, dass diese
+	 * ausgerichtet und vollständig in der Datei liegen.
+	 */
+	template <typename T> const T *next(std::uint64_t count)
+	{
+		if(m_offset % alignof(T) != 0)
+			throw std::runtime_error("misaligned snapshot section");
+		if(count > (m_size - m_offset) / sizeof(T))
+			throw std::runtime_error("truncated snapshot");
+		const T *section = reinterpret_cast<const T *>(m_data + m_offset);
+		m_offset += count * sizeof(T);
+		return section;
+	}
+};
+
+std::unique_ptr<Snapshot> Snapshot::load(const std::string &path)
+{
+	MappedSnapshot mapped(path);
+
+	const SnapshotHeader &header = *mapped.next<SnapshotHeader>(1);
+	if(std::memcmp(header.magic, s_snapshot_magic, sizeof(header.magic)) != 0
+		|| header.version != s_snapshot_version)
+		throw std::runtime_error("invalid snapshot " + path);
+
+	const SnapshotAddress *addresses = mapped.next<SnapshotAddress>(header.addresses);
+	const SnapshotStudent *students = mapped.next<SnapshotStudent>(header.students);
+	const SnapshotTeacher *teachers = mapped.next<SnapshotTeacher>(header.teachers);
+	const SnapshotCourse *courses = mapped.next<SnapshotCourse>(header.courses);
+	const SnapshotWaiting *waiting = mapped.next<SnapshotWaiting>(header.waiting);
+	const std::uint32_t *enlistments = mapped.next<std::uint32_t>(header.enlistments);
+	const SnapshotSlot *slots = mapped.next<SnapshotSlot>(header.slots);
+	const char *string_data = mapped.next<char>(header.strings);
+
+	auto text = [&](SnapshotString ref) {
+		if(ref.offset > header.strings || ref.length > header.strings - ref.offset)
+			throw std::runtime_error("invalid snapshot string");
+		return std::string_view(string_data + ref.offset, ref.length);
+	};
+	auto checked = [](std::uint32_t index, std::uint64_t count) {
+		if(index >= count)
+			throw std::runtime_error("invalid snapshot reference");
+		return index;
+	};
+
+	std::unique_ptr<Snapshot> snapshot(new Snapshot());
+
+	std::vector<Address *> address_list;
+	address_list.reserve(header.addresses);
+	for(std::uint64_t i = 0; i < header.addresses; i++)
+	{
+		const SnapshotAddress &record = addresses[i];
+		address_list.emplace_back(snapshot->m_addresses.create(text(record.street), record.street_no,
+			text(record.zipcode), text(record.city), text(record.country), Prevalidated()));
+	}
+
+	snapshot->m_university.reset(new University(std::string(text(header.university_name)),
+		*address_list[checked(header.university_address, header.addresses)]));
+	University &university = *snapshot->m_university;
+
+	snapshot->m_student_list.reserve(header.students);
+	std::vector<Student *> enrolled;
+	for(std::uint64_t i = 0; i < header.students; i++)
+	{
+		const SnapshotStudent &record = students[i];
+		Student *student = snapshot->m_students.create(text(record.first_name), text(record.last_name),
+			Date(record.birthday), *address_list[checked(record.address, header.addresses)],
+			record.student_number, Prevalidated());
+		snapshot->m_student_list.emplace_back(student);
+		if(record.enrolled)
+			enrolled.emplace_back(student);
+	}
+	if(!university.restore_students(enrolled))
+		throw std::runtime_error("invalid snapshot student");
+
+	snapshot->m_teacher_list.reserve(header.teachers);
+	std::vector<std::pair<Teacher *, std::int32_t>> hired;
+	for(std::uint64_t i = 0; i < header.teachers; i++)
+	{
+		const SnapshotTeacher &record = teachers[i];
+		if(record.hired && record.loan < 1000)
+			throw std::runtime_error("invalid snapshot teacher");
+		Teacher *teacher = snapshot->m_teachers.create(text(record.first_name), text(record.last_name),
+			Date(record.birthday), *address_list[checked(record.address, header.addresses)],
+			record.staff_number, Prevalidated());
+		snapshot->m_teacher_list.emplace_back(teacher);
+		if(record.hired)
+			hired.emplace_back(teacher, record.loan);
+	}
+	if(!university.restore_teachers(hired))
+		throw std::runtime_error("invalid snapshot teacher");
+
+	// Die Beziehungen werden direkt aus den Indexfeldern hergestellt. Der
+	// Zustand war beim Schreiben bereits gültig, Wochenpläne werden deshalb
+	// nicht erneut auf Überschneidungen geprüft.
+	university.m_courses.reserve(header.courses);
+	university.m_course_index.reserve(header.courses);
+	std::vector<TimeSlot> course_slots;
+	std::vector<Student *> course_students;
+	std::vector<std::pair<Student *, std::int64_t>> course_waiting;
+	for(std::uint64_t i = 0; i < header.courses; i++)
+	{
+		const SnapshotCourse &record = courses[i];
+		if(record.name.length < 10)
+			throw std::runtime_error("invalid snapshot course");
+		// Ein doppelter Name würde im Namensverzeichnis nur den ersten Eintrag
+		// behalten, das zweite Seminar wäre nicht mehr auffindbar.
+		std::string_view name = text(record.name);
+		if(university.m_course_index.count(name) != 0)
+			throw std::runtime_error("invalid snapshot");
+		Course &course = university.add_course(std::string(name));
+		Teacher *teacher = NULL;
+		if(record.teacher != s_no_index)
+			teacher = snapshot->m_teacher_list[checked(record.teacher, header.teachers)];
+
+		if(record.first_slot > header.slots || record.slot_count > header.slots - record.first_slot)
+			throw std::runtime_error("invalid snapshot slot");
+		course_slots.clear();
+		for(std::uint32_t k = 0; k < record.slot_count; k++)
+		{
+			const SnapshotSlot &slot = slots[record.first_slot + k];
+			if(slot.begin >= slot.end || slot.end > TimeSlot::s_minutes_per_week)
+				throw std::runtime_error("invalid snapshot slot");
+			course_slots.emplace_back(TimeSlot{slot.begin, slot.end});
+		}
+
+		if(record.first_student > header.enlistments
+			|| record.student_count > header.enlistments - record.first_student)
+			throw std::runtime_error("invalid snapshot enlistment");
+		course_students.clear();
+		for(std::uint32_t k = 0; k < record.student_count; k++)
+			course_students.emplace_back(snapshot->m_student_list[checked(enlistments[record.first_student + k], header.students)]);
+
+		if(record.first_waiting > header.waiting
+			|| record.waiting_count > header.waiting - record.first_waiting)
+			throw std::runtime_error("invalid snapshot waitlist");
+		course_waiting.clear();
+		for(std::uint32_t k = 0; k < record.waiting_count; k++)
+		{
+			const SnapshotWaiting &entry = waiting[record.first_waiting + k];
+			course_waiting.emplace_back(snapshot->m_student_list[checked(entry.student, header.students)], entry.priority);
+		}
+
+		if(!course.restore(teacher, course_slots, course_students, course_waiting, record.capacity))
+			throw std::runtime_error("invalid snapshot course");
+	}
+
+	Student::reserve_numbers(header.last_student_number);
+	Teacher::reserve_numbers(header.last_staff_number);
+	return snapshot;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "persons.h"
+#include "pool.h"
+#include "university.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Binäres Abbild einer Universität mit allen Adressen, Studierenden,
+ * Lehrkräften, Seminaren samt Kapazität, Warteliste und Zeiträumen und deren
+ * Beziehungen.
+ *
+ * Die Datei besteht aus einem Kopf mit Formatversion und Abschnittsgrößen,
+ * gefolgt von Feldern fester Größe je Objektart und einer gemeinsamen
+ * Zeichenkettentabelle. Beziehungen werden als Indizes in diese Felder
+ * gespeichert. Beim Laden wird die Datei per mmap eingeblendet und die Objekte
+ * direkt aus den eingeblendeten Feldern erzeugt, ohne die Validierung der
+ * Konstruktoren erneut auszuführen. Auch die Beziehungen werden direkt aus den
+ * Indexfeldern hergestellt, ohne die Wochenpläne erneut zu prüfen und ohne
+ * MutationListener zu benachrichtigen. Die Zähler für Matrikel- und
+ * Personalnummern werden dabei so weit erhöht, dass neue Nummern eindeutig
+ * bleiben.
+ *
+ * Ein geladener Snapshot besitzt alle wiederhergestellten Objekte, diese
+ * bleiben bis zu seiner Zerstörung gültig.
+ */
+class Snapshot {
+private:
+  Pool<Address> m_addresses;
+  Pool<Student> m_students;
+  Pool<Teacher> m_teachers;
+  std::vector<Student *> m_student_list;
+  std::vector<Teacher *> m_teacher_list;
+  std::unique_ptr<University> m_university;
+
+  Snapshot();
+
+public:
+  Snapshot(const Snapshot &) = delete;
+  Snapshot &operator=(const Snapshot &) = delete;
+
+  /**
+   * @brief Schreibt die Universität mit allen ihren Mitgliedern, Seminaren
+   * und den Teilnehmenden der Seminare in die Datei.
+   *
+   * @throws std::runtime_error Wenn die Datei nicht geschrieben werden kann.
+   */
+  static void save(University &university, const std::string &path);
+
+  /**
+   * @brief Lädt einen mit save geschriebenen Snapshot.
+   *
+   * @throws std::runtime_error Wenn die Datei nicht gelesen werden kann oder
+   * kein gültiger Snapshot ist.
+   */
+  static std::unique_ptr<Snapshot> load(const std::string &path);
+
+  /**
+   * @return University& Die wiederhergestellte Universität.
+   */
+  University &university() { return *m_university; }
+
+  /**
+   * @return Alle wiederhergestellten Studierenden, auch solche welche nur
+   * an einem Seminar teilnehmen ohne immatrikuliert zu sein.
+   */
+  std::vector<Student *> &students() { return m_student_list; }
+
+  /**
+   * @return Alle wiederhergestellten Lehrkräfte.
+   */
+  std::vector<Teacher *> &teachers() { return m_teacher_list; }
+};
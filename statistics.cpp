@@ -0,0 +1,164 @@
+#include "statistics.h"
+#include "persons.h"
+#include "university.h"
+
+EnrollmentStatistics::EnrollmentStatistics(University &university):
+	m_university(university), m_enrolled(0), m_enlistments(0), m_courses_without_teacher(0)
+{
+	for(Course *course : university.list_courses())
+	{
+		add_course(*course, 0, course->teacher() != NULL);
+		for(Student *student : course->list_students())
+			add_enlistment(*course, student->student_number());
+	}
+	for(Student *student : university.list_students())
+		enrolled(*student);
+
+	m_university.add_listener(*this);
+}
+
+EnrollmentStatistics::~EnrollmentStatistics()
+{
+	m_university.remove_listener(*this);
+}
+
+/*
+ * Verschiebt einen Eintrag der Verteilung von einer Stelle zur anderen. Leere
+ * Stellen am Ende werden entfernt, die letzte Stelle ist damit immer das
+ * Maximum.
+ */
+void EnrollmentStatistics::move(std::vector<std::size_t> &distribution, std::size_t from, std::size_t to)
+{
+	if(to >= distribution.size())
+		distribution.resize(to + 1, 0);
+	distribution[from]--;
+	distribution[to]++;
+	trim(distribution);
+}
+
+void EnrollmentStatistics::trim(std::vector<std::size_t> &distribution)
+{
+	while(distribution.size() > 1 && distribution.back() == 0)
+		distribution.pop_back();
+}
+
+void EnrollmentStatistics::add_course(const Course &course, std::size_t students, bool taught)
+{
+	m_courses.emplace(&course, CourseEntry{students, taught});
+	if(m_students_per_course.empty())
+		m_students_per_course.resize(1, 0);
+	m_students_per_course[0]++;
+	if(!taught)
+		m_courses_without_teacher++;
+}
+
+void EnrollmentStatistics::add_enlistment(const Course &course, std::int32_t student_number)
+{
+	CourseEntry &entry = m_courses[&course];
+	move(m_students_per_course, entry.students, entry.students + 1);
+	entry.students++;
+	m_enlistments++;
+
+	StudentEntry &student = m_students[student_number];
+	if(student.enrolled)
+		move(m_courses_per_student, student.courses, student.courses + 1);
+	student.courses++;
+}
+
+EnrollmentFigures EnrollmentStatistics::figures() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return EnrollmentFigures{m_enrolled, m_courses.size(), m_enlistments,
+		m_students_per_course.empty() ? 0 : m_students_per_course[0], m_courses_without_teacher,
+		m_students_per_course.empty() ? 0 : m_students_per_course.size() - 1};
+}
+
+std::vector<std::size_t> EnrollmentStatistics::students_per_course() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_students_per_course;
+}
+
+std::vector<std::size_t> EnrollmentStatistics::courses_per_student() const
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_courses_per_student;
+}
+
+void EnrollmentStatistics::enrolled(const Student &student)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	StudentEntry &entry = m_students[student.student_number()];
+	if(entry.enrolled)
+		return;
+
+	entry.enrolled = true;
+	if(entry.courses >= m_courses_per_student.size())
+		m_courses_per_student.resize(entry.courses + 1, 0);
+	m_courses_per_student[entry.courses]++;
+	m_enrolled++;
+}
+
+void EnrollmentStatistics::exmatriculated(const Student &student)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	auto it = m_students.find(student.student_number());
+	if(it == m_students.end() || !it->second.enrolled)
+		return;
+
+	it->second.enrolled = false;
+	m_courses_per_student[it->second.courses]--;
+	trim(m_courses_per_student);
+	m_enrolled--;
+	if(it->second.courses == 0)
+		m_students.erase(it);
+}
+
+void EnrollmentStatistics::course_offered(const Course &course)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	add_course(course, 0, false);
+}
+
+void EnrollmentStatistics::enlisted(const Course &course, const Student &student)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	add_enlistment(course, student.student_number());
+}
+
+void EnrollmentStatistics::left(const Course &course, const Student &student)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CourseEntry &entry = m_courses[&course];
+	move(m_students_per_course, entry.students, entry.students - 1);
+	entry.students--;
+	m_enlistments--;
+
+	auto it = m_students.find(student.student_number());
+	if(it->second.enrolled)
+		move(m_courses_per_student, it->second.courses, it->second.courses - 1);
+	if(--it->second.courses == 0 && !it->second.enrolled)
+		m_students.erase(it);
+}
+
+void EnrollmentStatistics::teacher_assigned(const Course &course, const Teacher &)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CourseEntry &entry = m_courses[&course];
+	if(!entry.taught)
+	{
+		entry.taught = true;
+		m_courses_without_teacher--;
+	}
+}
+
+void EnrollmentStatistics::teacher_resigned(const Course &course, const Teacher &)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	CourseEntry &entry = m_courses[&course];
+	if(entry.taught)
+	{
+		entry.taught = false;
+		m_courses_without_teacher++;
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include "listener.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class University;
+
+/**
+ * @brief Kennzahlen der Einschreibungen zu einem Zeitpunkt.
+ */
+struct EnrollmentFigures {
+  std::size_t students;
+  std::size_t courses;
+  std::size_t enlistments;
+  std::size_t empty_courses;
+  std::size_t courses_without_teacher;
+  std::size_t largest_course;
+
+  /**
+   * @return Die durchschnittliche Anzahl Studierender je Seminar.
+   */
+  double average_course_size() const { return courses > 0 ? static_cast<double>(enlistments) / courses : 0; }
+};
+
+/**
+ * @brief Laufend geführte Statistik über die Einschreibungen einer
+ * Universität. Die Statistik meldet sich als MutationListener an und führt
+ * bei jeder Immatrikulation, Ein- und Austragung und Zuweisung einer
+ * Lehrkraft die Kennzahlen und Verteilungen in O(1) nach, ohne Seminare oder
+ * Studierende anzufassen. Beim Anmelden wird der vorhandene Bestand einmal
+ * gezählt.
+ *
+ * Die Verteilung "Seminare je Studierendem" berücksichtigt nur an der
+ * Universität immatrikulierte Studierende, Seminare zählen auch Teilnehmende
+ * ohne Immatrikulation. Die Methoden sind threadsicher, die Statistik kann
+ * damit auch hinter der RegistrationEngine genutzt werden. Sie muss vor der
+ * Universität zerstört werden.
+ */
+class EnrollmentStatistics : public MutationListener {
+private:
+  struct CourseEntry {
+    std::size_t students;
+    bool taught;
+  };
+
+  struct StudentEntry {
+    std::size_t courses;
+    bool enrolled;
+  };
+
+  University &m_university;
+  mutable std::mutex m_lock;
+  std::unordered_map<const Course *, CourseEntry> m_courses;
+  std::unordered_map<std::int32_t, StudentEntry> m_students;
+  std::vector<std::size_t> m_students_per_course;
+  std::vector<std::size_t> m_courses_per_student;
+  std::size_t m_enrolled;
+  std::size_t m_enlistments;
+  std::size_t m_courses_without_teacher;
+
+  static void move(std::vector<std::size_t> &distribution, std::size_t from, std::size_t to);
+  static void trim(std::vector<std::size_t> &distribution);
+  void add_course(const Course &course, std::size_t students, bool taught);
+  void add_enlistment(const Course &course, std::int32_t student_number);
+
+public:
+  /**
+   * @brief Zählt den Bestand der Universität und meldet die Statistik an.
+   */
+  explicit EnrollmentStatistics(University &university);
+
+  EnrollmentStatistics(const EnrollmentStatistics &) = delete;
+  EnrollmentStatistics &operator=(const EnrollmentStatistics &) = delete;
+
+  /**
+   * @brief Meldet die Statistik von der Universität ab.
+   */
+  virtual ~EnrollmentStatistics();
+
+  /**
+   * @return Die aktuellen Kennzahlen, in O(1).
+   */
+  EnrollmentFigures figures() const;
+
+  /**
+   * @return Eintrag k ist die Anzahl der Seminare mit k Studierenden.
+   */
+  std::vector<std::size_t> students_per_course() const;
+
+  /**
+   * @return Eintrag k ist die Anzahl der immatrikulierten Studierenden mit k
+   * Seminaren.
+   */
+  std::vector<std::size_t> courses_per_student() const;
+
+  void enrolled(const Student &student) override;
+  void exmatriculated(const Student &student) override;
+  void course_offered(const Course &course) override;
+  void enlisted(const Course &course, const Student &student) override;
+  void left(const Course &course, const Student &student) override;
+  void teacher_assigned(const Course &course, const Teacher &teacher) override;
+  void teacher_resigned(const Course &course, const Teacher &teacher) override;
+};
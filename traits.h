@@ -1,19 +1,46 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+/**
+ * @brief Markiert Konstruktoren welche die Validierung der Daten überspringen,
+ * da diese bereits geprüft wurden, z.B. beim Laden eines Snapshots.
+ */
+struct Prevalidated {};
+
 class Displayable {
 public:
-  virtual std::string to_string() const = 0;
+  /**
+   * @brief Hängt die menschenlesbare Darstellung des Objekts an den
+   * übergebenen Puffer an. Der Puffer kann vom Aufrufer für viele Objekte
+   * wiederverwendet werden, womit keine neuen Strings erzeugt werden müssen.
+   *
+   * @param buffer Puffer an den die Darstellung angehängt wird.
+   */
+  virtual void append_to(std::string &buffer) const = 0;
+
+  /**
+   * @return std::string Die menschenlesbare Darstellung des Objekts als neuer
+   * String, erzeugt über append_to.
+   */
+  std::string to_string() const;
 };
 
 /**
  * Gibt ein beliebiges Objekt welches die abstrakte Displayable implementiert
- * auf der Standardausgabe aus, in dem es dessen to_string Methode nutzt. (2)
+ * auf der Standardausgabe aus, in dem es dessen append_to Methode nutzt. Der
+ * dafür genutzte Puffer wird zwischen den Aufrufen wiederverwendet. (2)
  *
  * @param displayable Das Objekt welches ausgegeben wird.
  */
 void print_stdout(Displayable &displayable);
 
+/**
+ * Hängt die Dezimaldarstellung der Zahl an den Puffer an, ohne dafür einen
+ * Zwischenstring oder Stream zu erzeugen.
+ */
+void append_number(std::string &buffer, std::int64_t value);
+
 bool all_digits(const std::string &str);
 bool digits_exist(const std::string &str);
@@ -1,36 +1,52 @@
 #include "university.h"
+#include "formatting.h"
+#include "instrumentation.h"
+#include "person_index.h"
 #include "persons.h"
 #include "traits.h"
-#include <sstream>
+#include "validation.h"
+#include <charconv>
 #include <stdexcept>
 #include <iostream>
-#include <cctype>
+#include <algorithm>
+#include <utility>
+#include <thread>
 
 bool digits_exist(const std::string &str)
 {
-	for (char c : str) {
-        if (std::isdigit(c)) {
-            return true;
-        }
-    }
-    return false;
+	return count_digits(str) != 0;
 }
 
 bool all_digits(const std::string &str)
 {
-	for (char c : str) {
-        if (!std::isdigit(c)) {
-            return false;
-        }
-    }
-    return true;
+	return count_digits(str) == str.size();
+}
+
+void append_number(std::string &buffer, std::int64_t value)
+{
+	char digits[24];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+	buffer.append(digits, result.ptr);
+}
+
+std::string Displayable::to_string() const
+{
+	std::string str;
+	append_to(str);
+	return str;
 }
 
 void print_stdout(Displayable &displayable){
-	std::cout << displayable.to_string() << std::endl;
+	static thread_local std::string buffer;
+
+	buffer.clear();
+	displayable.append_to(buffer);
+	buffer += '\n';
+	std::cout.write(buffer.data(), buffer.size());
+	std::cout.flush();
 }
 
-University::University(const std::string &name, Address &address): m_address(address), Displayable()
+University::University(const std::string &name, Address &address): Displayable(), m_address(address)
 {
 	if(name.length() >= 10){
 		m_name = name;
@@ -38,133 +54,318 @@ University::University(const std::string &name, Address &address): m_address(add
  
 }
 
-University::~University(){}
+University::~University()
+{
+	m_listeners.clear();
+	m_student_index.reset();
+	m_teacher_index.reset();
+	while(!m_students.empty())
+		m_students.items().back()->exmatriculate();
+	while(!m_teachers.empty())
+		m_teachers.items().back()->lay_off();
+
+	m_course_index.clear();
+	m_courses.clear();
+	m_course_pool.clear();
+}
+
+void University::add_student(Student &student)
+{
+	if(!m_students.insert(student.student_number(), &student))
+		return;
+
+	if(m_student_columns)
+		m_student_columns->push_back(student);
+	if(m_student_index)
+		m_student_index->insert(student);
+	notify([&](MutationListener &listener){ listener.enrolled(student); });
+}
+
+void University::remove_student(Student &student)
+{
+	std::size_t pos = m_students.position(student.student_number());
+	if(pos == m_students.size())
+		return;
+
+	m_students.erase(student.student_number());
+	if(m_student_columns)
+		m_student_columns->erase(pos);
+	if(m_student_index)
+		m_student_index->erase(student);
+	notify([&](MutationListener &listener){ listener.exmatriculated(student); });
+}
+
+void University::relocated(Student &student, const Address &previous)
+{
+	if(m_student_index && m_students.contains(student.student_number()))
+		m_student_index->relocate(student, previous);
+	if(!m_student_columns)
+		return;
+
+	std::size_t pos = m_students.position(student.student_number());
+	if(pos != m_students.size())
+		m_student_columns->relocate(pos, student.place_of_residence());
+}
+
+void University::relocated(Teacher &teacher, const Address &previous)
+{
+	if(m_teacher_index && m_teachers.contains(teacher.staff_number()))
+		m_teacher_index->relocate(teacher, previous);
+}
+
+void University::loan_changed(Teacher &teacher)
+{
+	std::size_t pos = m_teachers.position(teacher.staff_number());
+	if(pos == m_teachers.size())
+		return;
+
+	m_payroll.set(pos, teacher.loan());
+	notify([&](MutationListener &listener){ listener.loan_changed(teacher, teacher.loan()); });
+}
 
 void University::enroll(Student &student)
 {
-	if(student.university() == NULL)
+	CAMPUS_INSTRUMENT("University::enroll");
+	if(!m_students.contains(student.student_number()))
 	{
-		m_students.emplace_back(&student);
+		add_student(student);
+		student.enroll(*this);
 	}
-	student.enroll(*this);
 }
 
-void University::exmatriculate(Student &student)
+void University::enroll_batch(const std::vector<Student *> &students)
 {
-	int pos = 0;
-	if(student.university() == this)
+	CAMPUS_INSTRUMENT("University::enroll_batch");
+	CAMPUS_SCANNED(students.size());
+	m_students.reserve(m_students.size() + students.size());
+
+	for(Student *student : students)
 	{
-		for(auto& ptr : m_students)
-		{
-			if(student.student_number() == ptr->student_number())
-			{
-				m_students.erase(m_students.begin()+pos);
-				student.exmatriculate();
-				break;
-			}
-			pos++;
-		}
+		if(student->m_university == this)
+			continue;
+		if(student->m_university != NULL)
+			student->m_university->exmatriculate(*student);
+
+		add_student(*student);
+		student->m_university = this;
 	}
 }
 
-void University::hire(Teacher &teacher, std::int32_t loan)
+void University::exmatriculate(Student &student)
 {
-	bool found = false;
-	for(auto& ptr : m_teachers)
+	CAMPUS_INSTRUMENT("University::exmatriculate");
+	if(student.university() == this && m_students.contains(student.student_number()))
 	{
-		if(teacher.first_name() == ptr->first_name())
-		{
-			if(teacher.last_name() == ptr->last_name())
-			{
-				found = true;
-				break;
-			}
-		}
-	}
-	if (!found){
-		m_teachers.emplace_back(&teacher);
-		teacher.hire(*this, loan);
+		// Das Austragen aus dem Register ist O(1), linear ist nur noch die
+		// Benachrichtigung der Listener.
+		CAMPUS_SCANNED(1 + m_listeners.size());
+		remove_student(student);
+		student.exmatriculate();
 	}
 }
 
+void University::enable_student_columns()
+{
+	if(m_student_columns)
+		return;
+
+	m_student_columns.reset(new StudentColumns());
+	for(Student *student : m_students.items())
+		m_student_columns->push_back(*student);
+}
+
+void University::enable_person_indexes()
+{
+	if(m_student_index)
+		return;
+
+	m_student_index.reset(new PersonIndex<Student>());
+	for(Student *student : m_students.items())
+		m_student_index->insert(*student);
+	m_teacher_index.reset(new PersonIndex<Teacher>());
+	for(Teacher *teacher : m_teachers.items())
+		m_teacher_index->insert(*teacher);
+}
+
+void University::hire(Teacher &teacher, std::int32_t loan)
+{
+	CAMPUS_INSTRUMENT("University::hire");
+	if(m_teachers.contains(teacher.staff_number()))
+		return;
+
+	if(loan < 1000)
+		throw std::domain_error("Salary too low");
+
+	m_teachers.insert(teacher.staff_number(), &teacher);
+	teacher.hire(*this, loan);
+	m_payroll.push_back(loan);
+	if(m_teacher_index)
+		m_teacher_index->insert(teacher);
+	notify([&](MutationListener &listener){ listener.hired(teacher, loan); });
+}
+
 void University::lay_off(Teacher &teacher)
 {
-	int pos = 0;
-	if(teacher.university() == this)
+	CAMPUS_INSTRUMENT("University::lay_off");
+	std::size_t pos = m_teachers.position(teacher.staff_number());
+	if(teacher.university() == this && pos != m_teachers.size())
 	{
-		for(auto& ptr : m_students)
-		{
-			if(teacher.first_name() == ptr->first_name())
-			{
-				if(teacher.last_name() == ptr->last_name())
-				{
-					m_teachers.erase(m_teachers.begin()+pos);
-					teacher.lay_off();
-					break;
-				}
-			}
-			pos++;
-		}
+		CAMPUS_SCANNED(1 + m_listeners.size());
+		m_teachers.erase(teacher.staff_number());
+		m_payroll.erase(pos);
+		teacher.lay_off();
+		if(m_teacher_index)
+			m_teacher_index->erase(teacher);
+		notify([&](MutationListener &listener){ listener.laid_off(teacher); });
 	}
 }
 
-std::string University::to_string() const
+void University::add_listener(MutationListener &listener)
 {
-	std::stringstream strstream;
-	strstream << "Universität: " << m_name << "\n\n";
-	strstream << m_address.to_string() ;
-	strstream << "Anzahl Studierender: " << m_students.size() << "\n";
+	if(std::find(m_listeners.begin(), m_listeners.end(), &listener) == m_listeners.end())
+		m_listeners.emplace_back(&listener);
+}
 
-	for(auto i=0; i < m_students.size(); i++ )
-	{
-		strstream << i + 1 << " " << m_students[i]->first_name() << " "
-			<< m_students[i]->last_name() <<"\n";
-	}
+void University::remove_listener(MutationListener &listener)
+{
+	m_listeners.erase(std::remove(m_listeners.begin(), m_listeners.end(), &listener), m_listeners.end());
+}
+
+void University::append_to(std::string &buffer) const
+{
+	buffer += "Universität: ";
+	buffer += m_name;
+	buffer += "\n\n";
+	m_address.append_to(buffer);
+
+	const std::vector<Student *> &students = m_students.items();
+	buffer += "Anzahl Studierender: ";
+	append_number(buffer, students.size());
+	buffer += '\n';
+	for(std::size_t i = 0; i < students.size(); i++)
+		append_roster_line(buffer, i + 1, students[i]->first_name(), students[i]->last_name());
+
+	const std::vector<Teacher *> &teachers = m_teachers.items();
+	buffer += "\nAnzahl Lehrkräfte: ";
+	append_number(buffer, teachers.size());
+	buffer += '\n';
+	for(std::size_t i = 0; i < teachers.size(); i++)
+		append_roster_line(buffer, i + 1, teachers[i]->first_name(), teachers[i]->last_name());
+
+	buffer += "\nAnzahl Seminare: ";
+	append_number(buffer, m_courses.size());
+	buffer += '\n';
+	for(std::size_t i = 0; i < m_courses.size(); i++)
+		append_roster_line(buffer, i + 1, m_courses[i]->name());
+}
 
-	strstream << "\nAnzahl Lehrkräfte: " << m_teachers.size() << "\n";
-	for(auto i=0; i < m_teachers.size(); i++ )
+Course& University::add_course(const std::string &name)
+{
+	Course *course = m_course_pool.create(name);
+	course->m_university = this;
+	m_courses.emplace_back(course);
+	m_course_index.emplace(course->name(), course);
+	notify([&](MutationListener &listener){ listener.course_offered(*course); });
+	return *course;
+}
+
+bool University::restore_students(const std::vector<Student *> &students)
+{
+	m_students.reserve(m_students.size() + students.size());
+	for(Student *student : students)
 	{
-		strstream << i + 1 << " " << m_teachers[i]->first_name() << " "
-			<< m_teachers[i]->last_name() <<"\n";
+		if(!m_students.insert(student->student_number(), student))
+			return false;
+		student->m_university = this;
+		if(m_student_columns)
+			m_student_columns->push_back(*student);
+		if(m_student_index)
+			m_student_index->insert(*student);
 	}
+	return true;
+}
 
-	strstream << "\nAnzahl Seminare: " << m_courses.size() << "\n";
-	for(auto i=0; i < m_courses.size(); i++ )
+bool University::restore_teachers(const std::vector<std::pair<Teacher *, std::int32_t>> &teachers)
+{
+	m_teachers.reserve(m_teachers.size() + teachers.size());
+	m_payroll.reserve(m_teachers.size() + teachers.size());
+	for(const std::pair<Teacher *, std::int32_t> &entry : teachers)
 	{
-		strstream << i + 1 << " " << m_courses[i].name() << "\n";
+		Teacher &teacher = *entry.first;
+		if(!m_teachers.insert(teacher.staff_number(), &teacher))
+			return false;
+		teacher.m_university = this;
+		teacher.m_loan = entry.second;
+		m_payroll.push_back(entry.second);
+		if(m_teacher_index)
+			m_teacher_index->insert(teacher);
 	}
-
-	return strstream.str();
+	return true;
 }
 
 Course& University::offer_course(const std::string &name, Teacher &teacher)
 {
-	bool repeated = false;
-	Course& course = *(new Course(name));
-	
-	for(const auto& ptr: m_courses)
-	{
-		if(name == ptr.name())
-		{
-			repeated = true;
-			break;
-		}
-	}
+	CAMPUS_INSTRUMENT("University::offer_course");
+	auto it = m_course_index.find(name);
+	if(it != m_course_index.end())
+		return *it->second;
+
+	Course &course = add_course(name);
+	teacher.assign_course(course);
 
-	if(!repeated){
-		m_courses.emplace_back(course);
-		teacher.assign_course(course);
-	}
-	
 	return course;
 }
 
+std::vector<ScheduleConflict> University::find_conflicts(std::size_t threads)
+{
+	CAMPUS_INSTRUMENT("University::find_conflicts");
+	std::vector<Student *> &students = m_students.items();
+	std::vector<Teacher *> &teachers = m_teachers.items();
+	std::size_t count = students.size() + teachers.size();
+	threads = std::max<std::size_t>(1, std::min(threads, count));
+	CAMPUS_SCANNED(count);
+
+	auto scan = [](Person *person, const Schedule &schedule, std::vector<ScheduleConflict> &result) {
+		schedule.for_each_conflict([&](const Schedule::Entry &first, const Schedule::Entry &second){
+			TimeSlot overlap = {std::max(first.slot.begin, second.slot.begin), std::min(first.slot.end, second.slot.end)};
+			result.emplace_back(ScheduleConflict{person, first.course, second.course, overlap});
+		});
+	};
+
+	// Jeder Thread prüft einen zusammenhängenden Bereich der Personen und
+	// sammelt in seinem eigenen Vektor, die Ergebnisse werden danach in der
+	// Reihenfolge der Bereiche zusammengefügt.
+	std::vector<std::vector<ScheduleConflict>> results(threads);
+	auto work = [&](std::size_t part) {
+		std::size_t end = count * (part + 1) / threads;
+		for(std::size_t i = count * part / threads; i < end; i++)
+		{
+			if(i < students.size())
+				scan(students[i], students[i]->schedule(), results[part]);
+			else
+				scan(teachers[i - students.size()], teachers[i - students.size()]->schedule(), results[part]);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for(std::size_t part = 1; part < threads; part++)
+		workers.emplace_back(work, part);
+	work(0);
+	for(std::thread &worker : workers)
+		worker.join();
+
+	std::vector<ScheduleConflict> conflicts;
+	for(std::vector<ScheduleConflict> &part : results)
+		conflicts.insert(conflicts.end(), part.begin(), part.end());
+	return conflicts;
+}
+
 Address::Address(std::string street, std::int32_t street_no, 
 		std::string zipcode,std::string city, std::string country): 
 	Displayable()
 {
 	if (street.length() >= 10){
-		m_street = street;
+		m_street = InternedString(street);
 	} 
 	else throw std::domain_error("Invalid street name");
 
@@ -174,116 +375,309 @@ Address::Address(std::string street, std::int32_t street_no,
 	else throw std::domain_error("Invalid street number");
 
 	if (all_digits(zipcode) && zipcode.length() == 5){
-		m_zipcode = zipcode;
+		m_zipcode = std::move(zipcode);
 	}
 	else throw std::domain_error("Invalid zipcode");
 
 	if (city.length() >= 3){
-		m_city = city;
+		m_city = InternedString(city);
 	}
 	else throw std::domain_error("Invalid city");
 
 	if (country.length() >= 3){
-		m_country = country;
+		m_country = InternedString(country);
 	}
 	else throw std::domain_error("Invalid country");
 }
 
-std::string Address::to_string() const {
-	std::stringstream strstream;
-	std::string str;
+Address::Address(std::string_view street, std::int32_t street_no,
+		std::string_view zipcode, std::string_view city, std::string_view country,
+		Prevalidated):
+	Displayable(), m_street(street), m_street_no(street_no), m_zipcode(zipcode),
+	m_city(city), m_country(country){}
 
-	strstream << m_street << " " << m_street_no << "\n";
-	strstream << m_zipcode << " " << m_city << "\n";
-	strstream << m_country << "\n";
-		
-	str = strstream.str();	
-	return str;
+void Address::append_to(std::string &buffer) const
+{
+	char digits[12];
+	std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), m_street_no);
+	append_all(buffer, {m_street.str(), " ", std::string_view(digits, result.ptr - digits), "\n",
+		m_zipcode, " ", m_city.str(), "\n", m_country.str(), "\n"});
 }
 
-Course::Course(const std::string &name) : Displayable()
+std::atomic<std::uint32_t> Course::s_course_counter(0);
+
+Course::Course(const std::string &name) : Displayable(), m_id(s_course_counter++)
 {
 	if(name.length() >= 10){
 		m_name = name;
 	} else throw std::domain_error("invalid course name");
-	m_students.clear();
+	m_teacher = Enrollment<Teacher>{this, NULL, {NULL, NULL}, {NULL, NULL}};
+	m_university = NULL;
+	m_capacity = s_unlimited;
 }
 
-Course::~Course(){}
+Course::~Course()
+{
+	resign_teacher();
+	while(!m_students.empty())
+	{
+		Student *student = m_students.members().back();
+		m_students.erase(student->student_number(), student->m_courses);
+		student->m_schedule.erase(this);
+	}
+	for(const Waitlist<std::int32_t, Student>::Entry &entry : m_waitlist.entries())
+	{
+		entry.item->m_waitlists.erase(m_id);
+		entry.item->m_schedule.erase(this);
+	}
+}
 
-void Course::enlist(Student &student)
+bool Course::admit(Student &student)
 {
-	bool repeated = false;
-	
-	for(const auto& ptr: m_students)
+	if(!m_students.insert(student.student_number(), this, &student, student.m_courses))
+		return false;
+
+	if(m_university != NULL)
+		m_university->notify([&](MutationListener &listener){ listener.enlisted(*this, student); });
+	return true;
+}
+
+void Course::queue(Student &student, std::int64_t priority)
+{
+	if(m_students.contains(student.student_number())
+		|| !m_waitlist.push(student.student_number(), &student, priority))
+		return;
+
+	student.m_waitlists.insert(m_id, this);
+	if(m_university != NULL)
+		m_university->notify([&](MutationListener &listener){ listener.waitlisted(*this, student, priority); });
+}
+
+void Course::promote()
+{
+	while(m_students.size() < m_capacity && !m_waitlist.empty())
 	{
-		if(student.student_number() == ptr->student_number())
-		{
-			repeated = true;
-			break;
-		}
+		Student &student = *m_waitlist.front().item;
+		m_waitlist.pop_front();
+		student.m_waitlists.erase(m_id);
+		admit(student);
 	}
+}
 
-	if(!repeated){
-		m_students.emplace_back(&student);
-		student.enlist(*this);
+void Course::enlist(Student &student, std::int64_t priority)
+{
+	CAMPUS_INSTRUMENT("Course::enlist");
+	if(m_students.contains(student.student_number()) || m_waitlist.contains(student.student_number()))
+		return;
+
+	// Auch ein Platz auf der Warteliste belegt die Zeiträume im Wochenplan,
+	// beim Nachrücken kann damit keine Überschneidung entstehen.
+	CAMPUS_SCANNED(m_slots.size());
+	if(Course *other = student.m_schedule.conflict(m_slots))
+		throw std::domain_error("schedule conflicts with " + other->name());
+	student.m_schedule.insert(m_slots, this);
+
+	if(m_students.size() < m_capacity)
+		admit(student);
+	else
+		queue(student, priority);
+}
+
+void Course::enlist_batch(const std::vector<Student *> &students)
+{
+	CAMPUS_INSTRUMENT("Course::enlist_batch");
+	CAMPUS_SCANNED(students.size());
+	m_students.reserve(std::min(m_students.size() + students.size(), m_capacity));
+
+	for(Student *student : students)
+		enlist(*student);
+}
+
+void Course::enlist_batch(const std::vector<std::pair<Course *, Student *>> &enlistments)
+{
+	CAMPUS_INSTRUMENT("Course::enlist_batch(pairs)");
+	CAMPUS_SCANNED(enlistments.size());
+	// Nur gezählt wird je Seminar, die Kanten selbst werden in der
+	// übergebenen Reihenfolge angelegt. Ein Umsortieren würde die
+	// Reihenfolge in list_courses() und bei Überschneidungen im Wochenplan
+	// auch das Ergebnis verändern.
+	std::unordered_map<Course *, std::size_t> counts;
+	for(const std::pair<Course *, Student *> &enlistment : enlistments)
+		counts[enlistment.first]++;
+	for(const std::pair<Course *const, std::size_t> &count : counts)
+	{
+		Course &course = *count.first;
+		course.m_students.reserve(std::min(course.m_students.size() + count.second, course.m_capacity));
 	}
-	
+
+	for(const std::pair<Course *, Student *> &enlistment : enlistments)
+		enlistment.first->enlist(*enlistment.second);
 }
 
 void Course::leave(Student &student)
 {
-	int pos = 0;
-	for(const auto& ptr : m_students)	
+	CAMPUS_INSTRUMENT("Course::leave");
+	if(m_students.erase(student.student_number(), student.m_courses))
+	{
+		student.m_schedule.erase(this);
+		if(m_university != NULL)
+			m_university->notify([&](MutationListener &listener){ listener.left(*this, student); });
+		promote();
+	}
+	else if(m_waitlist.erase(student.student_number()))
+	{
+		student.m_waitlists.erase(m_id);
+		student.m_schedule.erase(this);
+		if(m_university != NULL)
+			m_university->notify([&](MutationListener &listener){ listener.left_waitlist(*this, student); });
+	}
+}
+
+void Course::set_capacity(std::size_t capacity)
+{
+	CAMPUS_INSTRUMENT("Course::set_capacity");
+	if(m_capacity == capacity)
+		return;
+
+	m_capacity = capacity;
+	if(m_university != NULL)
+		m_university->notify([&](MutationListener &listener){ listener.capacity_changed(*this, capacity); });
+	promote();
+}
+
+void Course::add_slot(const TimeSlot &slot)
+{
+	CAMPUS_INSTRUMENT("Course::add_slot");
+	if(slot.begin >= slot.end || slot.end > TimeSlot::s_minutes_per_week)
+		throw std::domain_error("invalid time slot");
+	for(const TimeSlot &other : m_slots)
+	{
+		if(other.overlaps(slot))
+			throw std::domain_error("overlapping time slot");
+	}
+
+	m_slots.emplace_back(slot);
+	CAMPUS_SCANNED(m_slots.size() + m_students.size() + m_waitlist.size());
+	if(m_teacher.member != NULL)
+		m_teacher.member->m_schedule.insert(slot, this);
+	for(Student *student : m_students.members())
+		student->m_schedule.insert(slot, this);
+	for(const Waitlist<std::int32_t, Student>::Entry &entry : m_waitlist.entries())
+		entry.item->m_schedule.insert(slot, this);
+	if(m_university != NULL)
+		m_university->notify([&](MutationListener &listener){ listener.slot_added(*this, slot); });
+}
+
+bool Course::restore(Teacher *teacher, const std::vector<TimeSlot> &slots, const std::vector<Student *> &students,
+	const std::vector<std::pair<Student *, std::int64_t>> &waiting, std::size_t capacity)
+{
+	for(std::size_t i = 0; i < slots.size(); i++)
 	{
-		if(student.student_number() == ptr->student_number())
+		for(std::size_t k = 0; k < i; k++)
 		{
-			m_students.erase(m_students.begin()+pos);
-			student.leave(*this);
-			break;
+			if(slots[k].overlaps(slots[i]))
+				return false;
 		}
-		pos++;
 	}
+	m_slots = slots;
+	m_capacity = capacity;
+
+	if(teacher != NULL)
+	{
+		m_teacher.member = teacher;
+		teacher->m_courses.push_back(m_teacher);
+		teacher->m_schedule.insert(m_slots, this);
+	}
+
+	m_students.reserve(students.size());
+	for(Student *student : students)
+	{
+		if(!m_students.insert(student->student_number(), this, student, student->m_courses))
+			return false;
+		student->m_schedule.insert(m_slots, this);
+	}
+
+	if(!waiting.empty() && m_students.size() < m_capacity)
+		return false;
+	for(const std::pair<Student *, std::int64_t> &entry : waiting)
+	{
+		Student &student = *entry.first;
+		if(m_students.contains(student.student_number())
+			|| !m_waitlist.push(student.student_number(), &student, entry.second))
+			return false;
+		student.m_waitlists.insert(m_id, this);
+		student.m_schedule.insert(m_slots, this);
+	}
+	return true;
+}
+
+bool Course::is_enlisted(const Student &student) const
+{
+	return m_students.contains(student.student_number());
+}
+
+bool Course::is_waitlisted(const Student &student) const
+{
+	return m_waitlist.contains(student.student_number());
 }
 
 void Course::assign_teacher(Teacher &teacher)
 {
-	m_teacher = &teacher;
-	teacher.assign_course(*this);
+	CAMPUS_INSTRUMENT("Course::assign_teacher");
+	if(m_teacher.member == &teacher)
+		return;
+	CAMPUS_SCANNED(m_slots.size());
+	if(Course *other = teacher.m_schedule.conflict(m_slots))
+		throw std::domain_error("schedule conflicts with " + other->name());
+
+	resign_teacher();
+	m_teacher.member = &teacher;
+	teacher.m_courses.push_back(m_teacher);
+	teacher.m_schedule.insert(m_slots, this);
+	if(m_university != NULL)
+		m_university->notify([&](MutationListener &listener){ listener.teacher_assigned(*this, teacher); });
 }
 
 void Course::resign_teacher()
 {
-	if(m_teacher != NULL)
+	CAMPUS_INSTRUMENT("Course::resign_teacher");
+	if(m_teacher.member != NULL)
 	{
-		m_teacher->resign_course(*this);	
-		m_teacher = NULL;
+		Teacher &teacher = *m_teacher.member;
+		teacher.m_courses.unlink(m_teacher);
+		teacher.m_schedule.erase(this);
+		m_teacher.member = NULL;
+		if(m_university != NULL)
+			m_university->notify([&](MutationListener &listener){ listener.teacher_resigned(*this, teacher); });
 	}
 }
 
-std::vector<Student *>& Course::list_students()
+const EnrollmentList<Student, EnrollmentSide::course> &Course::list_students() const
 {
-	return m_students;
+	return m_students.members();
 }
 
-Teacher* Course::teacher()
+Teacher* Course::teacher() const
 {
-	return m_teacher;
+	return m_teacher.member;
 }
 
-std::string Course::to_string() const
+void Course::append_to(std::string &buffer) const
 {
-	std::stringstream strstream;
-	strstream << "Seminar: " << m_name << "\n\n";
-	strstream << "Lehrkraft: " << m_teacher->first_name() << " " << m_teacher->last_name() << "\n\n";
-	strstream << "Anzahl Studierende: " << m_students.size() << "\n";
-	
-	for(auto i = 0; i < m_students.size(); i++)
+	buffer += "Seminar: ";
+	buffer += m_name;
+	buffer += "\n\nLehrkraft: ";
+	if(m_teacher.member != NULL)
 	{
-		strstream << i +1 << " " << m_students[i]->first_name() << " " << m_students[i]->last_name() << "\n";
+		buffer += m_teacher.member->first_name();
+		buffer += ' ';
+		buffer += m_teacher.member->last_name();
 	}
 
-	return strstream.str();
+	buffer += "\n\nAnzahl Studierende: ";
+	append_number(buffer, m_students.size());
+	buffer += '\n';
+	std::size_t i = 0;
+	for(Student *student : m_students.members())
+		append_roster_line(buffer, ++i, student->first_name(), student->last_name());
 }
-
-
@@ -1,14 +1,29 @@
 
 #pragma once
 #include "traits.h"
+#include "enrollment.h"
+#include "listener.h"
+#include "payroll.h"
 #include "persons.h"
+#include "pool.h"
+#include "registry.h"
+#include "roster.h"
+#include "schedule.h"
+#include "waitlist.h"
+#include <cstddef>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 class Address;
 class Course;
 class Student;
 class Teacher;
+template <typename T> class PersonIndex;
 
 /**
  * @brief Universität welche alle ihr untergeordneten Objekte wie
@@ -18,16 +33,54 @@ class Teacher;
  * (1)
  *
  * Die Klasse erbt die von der abstrakten Klasse Display die
- * Spezifikation der to_string Methode welche implementiert
+ * Spezifikation der append_to Methode welche implementiert
  * werden muss. (3)
  */
 class University : public Displayable {
+  friend class Course;
+  friend class Journal;
+  friend class Student;
+  friend class Teacher;
+  friend class Snapshot;
+
 private:
   std::string m_name;
   Address &m_address;
-  std::vector<Student *> m_students;
-  std::vector<Teacher *> m_teachers;
-  std::vector<Course> m_courses;
+  Registry<std::int32_t, Student> m_students;
+  Registry<std::int32_t, Teacher> m_teachers;
+  Pool<Course> m_course_pool;
+  std::vector<Course *> m_courses;
+  std::unordered_map<std::string_view, Course *> m_course_index;
+  std::unique_ptr<StudentColumns> m_student_columns;
+  std::unique_ptr<PersonIndex<Student>> m_student_index;
+  std::unique_ptr<PersonIndex<Teacher>> m_teacher_index;
+  Payroll m_payroll;
+  std::vector<MutationListener *> m_listeners;
+
+  /**
+   * @brief Ruft die Funktion für jeden angemeldeten MutationListener auf.
+   */
+  template <typename F> void notify(F event) const {
+    for(MutationListener *listener : m_listeners)
+      event(*listener);
+  }
+
+  void add_student(Student &student);
+  void remove_student(Student &student);
+  void relocated(Student &student, const Address &previous);
+  void relocated(Teacher &teacher, const Address &previous);
+  void loan_changed(Teacher &teacher);
+  Course &add_course(const std::string &name);
+
+  /**
+   * @brief Nimmt beim Laden eines Snapshots Studierende bzw. Lehrkräfte mit
+   * ihrem Gehalt auf. Registry und Gehaltsliste werden einmal auf die
+   * endgültige Größe gebracht, Listener werden nicht benachrichtigt.
+   *
+   * @return false Wenn eine Matrikel- oder Personalnummer doppelt vorkommt.
+   */
+  bool restore_students(const std::vector<Student *> &students);
+  bool restore_teachers(const std::vector<std::pair<Teacher *, std::int32_t>> &teachers);
 
 public:
   /**
@@ -39,10 +92,15 @@ public:
    */
   University(const std::string &name, Address &address);
 
+  University(const University &) = delete;
+  University &operator=(const University &) = delete;
+
   /**
    * @brief Destruktor der Universität. Dieser entlässt alle Lehrkräfte und
    * exmatrikuliert alle Studierenden. Diese Veränderung wird allen Lehrkräften
-   * und Studierenden mitgeteilt.
+   * und Studierenden mitgeteilt. Anschließend werden alle Seminare der
+   * Universität gemeinsam freigegeben. Angemeldete MutationListener werden
+   * vorher abgemeldet und erfahren vom Abbau nichts.
    */
   virtual ~University();
 
@@ -54,6 +112,17 @@ public:
    */
   void enroll(Student &student);
 
+  /**
+   * @brief Immatrikuliert alle übergebenen Studierenden in einem Durchlauf.
+   * Doppelte Einträge und bereits immatrikulierte Studierende werden
+   * übersprungen, Studierende einer anderen Universität werden dort
+   * exmatrikuliert. Der Endzustand entspricht dem einzelner enroll Aufrufe in
+   * derselben Reihenfolge, der Speicher wird aber nur einmal reserviert.
+   *
+   * @param students Studierende welche immatrikuliert werden.
+   */
+  void enroll_batch(const std::vector<Student *> &students);
+
   /**
    * @brief Exmatrikuliert den Studierenden falls dieser an der Universität
    * eingeschrieben ist. Der Studierende bekommt diese Veränderung mitgeteilt.
@@ -67,6 +136,8 @@ public:
    * schon an der Universität ist, diese bekommt seine neue Universität
    * zugewiesen.
    *
+   * @throws std::domain_error Wenn das Gehalt weniger als 1000€ beträgt.
+   *
    * @param teacher Lehrkraft welche angestellt wird.
    * @param loan Gehalt welches der Lehrkraft gezahlt wird.
    */
@@ -83,7 +154,10 @@ public:
   /**
    * @brief Erstellt ein neues Seminar aus den übergebenen Argumenten und
    * speichert dieses intern ab, falls dieser nicht schon existiert und weist
-   * der Lehrkraft den neuen Kurs zu.
+   * der Lehrkraft den neuen Kurs zu. Existiert bereits ein Seminar mit dem
+   * Namen, wird dieses zurückgegeben. Die Seminare liegen im Speicherpool der
+   * Universität, ihre Adressen bleiben bis zur Zerstörung der Universität
+   * gültig.
    *
    * @param name Der Name des Seminars
    * @param teacher Die Lehrkraft welche des Seminar hällt.
@@ -91,40 +165,141 @@ public:
    */
   Course &offer_course(const std::string &name, Teacher &teacher);
 
+  /**
+   * @brief Meldet einen Beobachter an, welcher ab jetzt über alle
+   * Veränderungen an der Universität, ihren Seminaren und deren Teilnehmenden
+   * benachrichtigt wird. Der Beobachter muss bis zu seiner Abmeldung gültig
+   * bleiben.
+   */
+  void add_listener(MutationListener &listener);
+
+  /**
+   * @brief Meldet einen zuvor angemeldeten Beobachter wieder ab.
+   */
+  void remove_listener(MutationListener &listener);
+
   /**
    *  @return Der Name der Universität.
    */
-  std::string name() const{return m_name;};
+  const std::string &name() const{return m_name;};
 
   /**
-   * @return std::vector<Teacher*>& Alle Lehrkräfte der Universität.
+   *  @return Die Adresse der Universität.
+   */
+  const Address &address() const{return m_address;}
+
+  /**
+   * @return std::vector<Teacher*>& Alle Lehrkräfte der Universität. Die
+   * Reihenfolge ändert sich wenn Lehrkräfte entlassen werden.
 
    */
 	std::vector<Teacher *> &list_teachers(){
-		return m_teachers;
+		return m_teachers.items();
 	};
 
   /**
-   * @return std::vector<Student*>& Alle Studierenden der Universität.
+   * @return std::vector<Student*>& Alle Studierenden der Universität. Die
+   * Reihenfolge ändert sich wenn Studierende exmatrikuliert werden.
    */
 	std::vector<Student *> &list_students(){
-		return m_students;
+		return m_students.items();
+	}
+
+  /**
+   * @param student_number Matrikelnummer des gesuchten Studierenden.
+   * @return Student* Der Studierende oder NULL falls dieser nicht an der
+   * Universität immatrikuliert ist.
+   */
+	Student *find_student(std::int32_t student_number) const{
+		return m_students.find(student_number);
 	}
 
   /**
-   * @return std::vector<Course>& Alle Seminare der Universität.
+   * @brief Legt die spaltenorientierte Kopie der Studierendendaten an, falls
+   * diese noch nicht existiert. Ab dann wird sie bei jeder Immatrikulation,
+   * Exmatrikulation und jedem Umzug eines Studierenden aktualisiert.
    */
-	std::vector<Course> &list_courses(){
+  void enable_student_columns();
+
+  /**
+   * @return StudentColumns* Die spaltenorientierte Kopie der Studierendendaten
+   * oder NULL falls diese nicht angelegt wurde. Die Zeilen stehen in derselben
+   * Reihenfolge wie list_students().
+   */
+  const StudentColumns *student_columns() const{
+    return m_student_columns.get();
+  }
+
+  /**
+   * @brief Legt die Suchindizes über Studierende und Lehrkräfte an, falls
+   * diese noch nicht existieren. Ab dann werden sie bei jeder
+   * Immatrikulation, Exmatrikulation, Anstellung, Entlassung und jedem Umzug
+   * aktualisiert.
+   */
+  void enable_person_indexes();
+
+  /**
+   * @return PersonIndex<Student>* Die Suchindizes über die Studierenden oder
+   * NULL falls diese nicht angelegt wurden.
+   */
+  const PersonIndex<Student> *student_index() const{
+    return m_student_index.get();
+  }
+
+  /**
+   * @return PersonIndex<Teacher>* Die Suchindizes über die Lehrkräfte oder
+   * NULL falls diese nicht angelegt wurden.
+   */
+  const PersonIndex<Teacher> *teacher_index() const{
+    return m_teacher_index.get();
+  }
+
+  /**
+   * @return Payroll& Die laufend geführte Gehaltsabrechnung über alle
+   * angestellten Lehrkräfte.
+   */
+  const Payroll &payroll() const{
+    return m_payroll;
+  }
+
+  /**
+   * @param staff_number Personalnummer der gesuchten Lehrkraft.
+   * @return Teacher* Die Lehrkraft oder NULL falls diese nicht an der
+   * Universität angestellt ist.
+   */
+	Teacher *find_teacher(std::int32_t staff_number) const{
+		return m_teachers.find(staff_number);
+	}
+
+  /**
+   * @brief Sucht alle Überschneidungen in den Wochenplänen der Studierenden
+   * und Lehrkräfte. Beim Einschreiben werden Überschneidungen abgelehnt, sie
+   * können aber entstehen wenn einem Seminar nachträglich ein Zeitraum
+   * hinzugefügt wird. Die Personen werden auf mehrere Threads aufgeteilt,
+   * welche die Wochenpläne nur lesen. Währenddessen darf die Universität
+   * nicht verändert werden.
+   *
+   * @param threads Anzahl der Threads.
+   * @return Die Überschneidungen, zuerst die der Studierenden in der
+   * Reihenfolge von list_students(), dann die der Lehrkräfte.
+   */
+  std::vector<ScheduleConflict> find_conflicts(std::size_t threads = 4);
+
+  /**
+   * @return std::vector<Course*>& Alle Seminare der Universität.
+   */
+	std::vector<Course *> &list_courses(){
 		return m_courses;
 	}
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Das Format ist folgendes:
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Das
+   * Format ist folgendes:
    *
    * Universität: University::name
    *
-   * Address::to_string
+   * Address::append_to
    *
    * Anzahl Studierender: xxx
    * Student::first_name Student::last_name (Für alle Studierenden)
@@ -135,10 +310,10 @@ public:
    * Anzahl Seminare: xxx
    * Course::name (Für alle Seminare)
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
 
 /**
@@ -149,15 +324,52 @@ public:
  * (1).
  *
  * Die Klasse erbt die von der abstrakten Klasse Display die Spezifikation der
- * to_string Methode welche implementiert werden muss. (3)
+ * append_to Methode welche implementiert werden muss. (3)
  */
 class Course : public Displayable {
+  friend class University;
+  friend class Snapshot;
+
 private:
+  const std::uint32_t m_id;
   std::string m_name;
-  std::vector<Student *> m_students;
-  Teacher *m_teacher;
+  EnrollmentTable<Student> m_students;
+  Enrollment<Teacher> m_teacher;
+  University *m_university;
+  std::size_t m_capacity;
+  Waitlist<std::int32_t, Student> m_waitlist;
+  std::vector<TimeSlot> m_slots;
+
+  /**
+   * @brief Zähler mit stastischer Lebensdauer der alle erstellten Seminare
+   * zählt, die Seminarnummer ergibt sich aus der aktuellen Zahl. Die Nummern
+   * sind damit dicht und eignen sich als Schlüssel für die Wartelisten der
+   * Studierenden. Der Zähler ist atomar.
+   */
+  static std::atomic<std::uint32_t> s_course_counter;
+
+  bool admit(Student &student);
+  void queue(Student &student, std::int64_t priority);
+  void promote();
+
+  /**
+   * @brief Stellt beim Laden eines Snapshots Lehrkraft, Zeiträume,
+   * Teilnehmende, Warteliste und Kapazität des noch leeren Seminars her. Die
+   * Kanten werden ohne Prüfung der Wochenpläne und ohne Benachrichtigung
+   * eingehängt, die Warteliste wird in der übergebenen Reihenfolge übernommen.
+   *
+   * @return false Wenn sich Zeiträume des Seminars überschneiden, ein
+   * Studierender doppelt vorkommt oder trotz freier Plätze jemand wartet.
+   */
+  bool restore(Teacher *teacher, const std::vector<TimeSlot> &slots, const std::vector<Student *> &students,
+               const std::vector<std::pair<Student *, std::int64_t>> &waiting, std::size_t capacity);
 
 public:
+  /**
+   * @brief Kapazität eines Seminars ohne Platzbeschränkung.
+   */
+  static constexpr std::size_t s_unlimited = std::numeric_limits<std::size_t>::max();
+
   /**
    * @brief Erzeugt das Course Objekt mit gültigen Daten, falls die Daten
    * ungültig sind wird im Konstruktor eine Exception vom Typ std::domain_error
@@ -170,37 +382,132 @@ public:
    */
   Course(const std::string &name);
 
+  Course(const Course &) = delete;
+  Course &operator=(const Course &) = delete;
+
   /**
-   * @brief Destruktor des Seminars. Dieser zieht die Lehrkräft aus dem Kurs ab
-   * und trägt alle Studierenden aus. Diese Veränderung wird auch der Lehrkräft
-   * und den Studierenden mitgeteilt.
+   * @brief Destruktor des Seminars. Dieser zieht die Lehrkraft aus dem Kurs ab
+   * und trägt alle Studierenden sowie die Warteliste aus, deren Seminarlisten
+   * und Wochenpläne werden dabei angepasst. MutationListener erfahren nur vom
+   * Abziehen der Lehrkraft, nicht vom Austragen der Studierenden.
    */
   virtual ~Course();
 
   /**
    * @brief Schreibt einen Studierenden in das Seminar ein, falls dieser nicht
    * schon eingeschrieben ist, der Studierende wird ebenfalls darüber
-   * benachrichtigt das er eingeschrieben wird.
+   * benachrichtigt das er eingeschrieben wird. Ist das Seminar voll, wird der
+   * Studierende stattdessen mit der Priorität auf die Warteliste gesetzt,
+   * sofern er dort noch nicht steht.
+   *
+   * @throws std::domain_error Wenn sich ein Zeitraum des Seminars mit dem
+   * Wochenplan des Studierenden überschneidet. Der Studierende wird dann
+   * weder eingeschrieben noch auf die Warteliste gesetzt.
    *
    * @param student Der einzuschreibende Student.
+   * @param priority Rang auf der Warteliste, z.B. der Zeitpunkt der Anfrage
+   * oder das negierte Fachsemester. Kleinere Werte rücken zuerst nach, bei
+   * gleichen Werten entscheidet die Reihenfolge der Anfragen.
    */
-  void enlist(Student &student);
+  void enlist(Student &student, std::int64_t priority = 0);
 
   /**
-   * @brief Trägt einen Studierenden aus dem Seminar aus, falls dieser
-   * eingeschrieben ist. Der Studierende wird ebenfalls darüber benachrichtigt
-   * das er ausgetragen wurde.
+   * @brief Schreibt alle übergebenen Studierenden in einem Durchlauf in das
+   * Seminar ein. Doppelte Einträge und bereits eingeschriebene Studierende
+   * werden übersprungen, sobald das Seminar voll ist landen die übrigen auf
+   * der Warteliste. Der Endzustand entspricht dem einzelner enlist Aufrufe in
+   * derselben Reihenfolge, der Speicher der Kanten wird aber nur einmal
+   * reserviert.
+   *
+   * @param students Die einzuschreibenden Studierenden.
+   */
+  void enlist_batch(const std::vector<Student *> &students);
+
+  /**
+   * @brief Schreibt Studierende in beliebig viele Seminare ein. Die Paare
+   * werden zunächst je Seminar gezählt, womit jedes Seminar seinen Speicher
+   * nur einmal reserviert, und dann in der übergebenen Reihenfolge
+   * eingeschrieben. Der Endzustand entspricht damit genau einzelnen enlist
+   * Aufrufen in derselben Reihenfolge, auch in list_courses().
+   *
+   * @param enlistments Paare aus Seminar und einzuschreibendem Studierenden.
+   */
+  static void enlist_batch(const std::vector<std::pair<Course *, Student *>> &enlistments);
+
+  /**
+   * @brief Trägt einen Studierenden aus dem Seminar oder von dessen Warteliste
+   * aus. Der Studierende wird ebenfalls darüber benachrichtigt das er
+   * ausgetragen wurde. Wird dadurch ein Platz frei, rückt der erste
+   * Studierende der Warteliste in O(log n) nach.
    *
    * @param student Der Student welcher ausgetragen wird.
    */
   void leave(Student &student);
 
+  /**
+   * @brief Setzt die Anzahl der Plätze des Seminars. Bei einer Erhöhung rücken
+   * entsprechend viele Studierende von der Warteliste nach, bei einer
+   * Verringerung bleiben bereits eingeschriebene Studierende eingeschrieben.
+   *
+   * @param capacity Anzahl der Plätze oder s_unlimited.
+   */
+  void set_capacity(std::size_t capacity);
+
+  /**
+   * @brief Fügt dem Seminar einen wöchentlichen Zeitraum hinzu. Dieser wird
+   * in die Wochenpläne der Lehrkraft sowie aller eingeschriebenen und
+   * wartenden Studierenden übernommen, Überschneidungen mit deren anderen
+   * Seminaren werden dabei nicht abgelehnt sondern über
+   * University::find_conflicts gemeldet.
+   *
+   * @throws std::domain_error Wenn sich der Zeitraum mit einem anderen
+   * Zeitraum des Seminars überschneidet.
+   *
+   * @param slot Der neue Zeitraum.
+   */
+  void add_slot(const TimeSlot &slot);
+
+  /**
+   * @return Die Zeiträume des Seminars in der Reihenfolge ihres Hinzufügens.
+   */
+  const std::vector<TimeSlot> &slots() const{
+    return m_slots;
+  }
+
+  /**
+   * @return Die Anzahl der Plätze des Seminars oder s_unlimited.
+   */
+  std::size_t capacity() const{
+    return m_capacity;
+  }
+
+  /**
+   * @return true Wenn der Studierende in das Seminar eingeschrieben ist.
+   */
+  bool is_enlisted(const Student &student) const;
+
+  /**
+   * @return true Wenn der Studierende auf der Warteliste des Seminars steht.
+   */
+  bool is_waitlisted(const Student &student) const;
+
+  /**
+   * @return Die Warteliste des Seminars in der Reihenfolge des Nachrückens.
+   */
+  const Waitlist<std::int32_t, Student> &waitlist() const{
+    return m_waitlist;
+  }
+
   /**
    * @brief Weist die Lehrkraft dem Seminar zu. Die Lehrkraft wird ebenfalls
    * darüber benachrichtigt das sie zugewiesen wurde. Falls eine Lehrkraft
    * bereits für den Kurs zuständig ist wird diese von diesem Kurs
    * zurückgezogen.
    *
+   * @throws std::domain_error Wenn sich ein Zeitraum des Seminars mit dem
+   * Wochenplan der Lehrkraft überschneidet, die bisherige Lehrkraft bleibt
+   * dann zuständig.
+   *
    * @param teacher Die Lehrkraft welche für das Seminar zuständig ist.
    */
   void assign_teacher(Teacher &teacher);
@@ -212,27 +519,36 @@ public:
   void resign_teacher();
 
   /**
-   * @return std::vector<Student&> Alle eingeschriebenen Studierenden des
-   * Kurses.
+   * @return Alle eingeschriebenen Studierenden des Kurses in der Reihenfolge
+   * ihrer Einschreibung.
    */
-  std::vector<Student *> &list_students();
+  const EnrollmentList<Student, EnrollmentSide::course> &list_students() const;
 
   /**
    * @return Teacher& Die Lehrkraft welche für den Kurs verantwortlich
-   * ist.
+   * ist oder NULL.
    */
-  Teacher *teacher();
+  Teacher *teacher() const;
 
   /**
    * @return Der Name des Kurses.
    */
-	std::string name() const{
+	const std::string &name() const{
 		return m_name;
 	}
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Er soll folgendes Format haben.
+   * @return Die fortlaufende Seminarnummer welche bei der Erstellung vergeben
+   * wird.
+   */
+	std::uint32_t id() const{
+		return m_id;
+	}
+
+  /**
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Er soll
+   * folgendes Format haben.
    *
    * Seminar: Name
    *
@@ -241,10 +557,10 @@ public:
    * Anzahl Studierende: xxx
    * Student::first_name Student::last_name (Für alle Studierenden)
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
 
 /**
@@ -256,15 +572,15 @@ public:
  * diese auch außerhalb der Klasse nicht verändert werden dürfen (1).
  *
  * Die Klasse erbt die von der abstrakten Klasse Display die Spezifikation der
- * to_string Methode welche implementiert werden muss. (3)
+ * append_to Methode welche implementiert werden muss. (3)
  */
 class Address : public Displayable {
 private:
-  std::string m_street;
+  InternedString m_street;
   std::int32_t m_street_no;
   std::string m_zipcode;
-  std::string m_city;
-  std::string m_country;
+  InternedString m_city;
+  InternedString m_country;
 
 
 public:
@@ -295,13 +611,21 @@ public:
   Address(std::string street, std::int32_t street_no, std::string zipcode,
   std::string city, std::string country);
 
+  /**
+   * @brief Erzeugt das Address Objekt aus bereits geprüften Daten, ohne diese
+   * erneut zu validieren.
+   */
+  Address(std::string_view street, std::int32_t street_no,
+  std::string_view zipcode, std::string_view city, std::string_view country,
+  Prevalidated);
+
   /**
    * @brief Gibt eine Referenz auf den Straßennamen zurück. Diese ist nicht
    * veränderlich.
    *
    * @return const std::string Der Straßenname
    */
-  const std::string &street() { return m_street; }
+  const std::string &street() const { return m_street; }
 
   /**
    * @brief Gibt eine Referenz auf die Hausnummer zurück. Diese ist nicht
@@ -320,30 +644,33 @@ public:
   const std::string &zip_code() const { return m_zipcode; }
 
   /**
-   * @brief Gibt eine Referenz auf den Stadtnamen zurück.
+   * @brief Gibt eine Referenz auf den Stadtnamen zurück. Gleiche Stadtnamen
+   * liefern dieselbe Referenz aus dem StringPool.
    *
    * @return const std::string Der Stadtname.
    */
   const std::string &city() const { return m_city; }
 
   /**
-   * @brief Gibt eine Referenz auf den Namen des Landes zurück.
+   * @brief Gibt eine Referenz auf den Namen des Landes zurück. Gleiche Namen
+   * liefern dieselbe Referenz aus dem StringPool.
    *
    * @return const std::string Der Name des Landes.
    */
   const std::string &country() const { return m_country; }
 
   /**
-   * @brief Gibt einen String zurück welcher menschenlesbar ist und für die
-   * Ausgabe gedacht ist. Das Format soll in dieser Form erfolgen, die Trennung
-   * erfolgt mit einem Leerzeichen und Zeilenumbruch am Ende der Zeile:
+   * @brief Hängt einen menschenlesbaren Text an den Puffer an, welcher für die
+   * Ausgabe gedacht ist. Es werden dabei keine Zwischenstrings erzeugt. Das
+   * Format soll in dieser Form erfolgen, die Trennung erfolgt mit einem
+   * Leerzeichen und Zeilenumbruch am Ende der Zeile:
    *
    * Straßenname Hausnummer
    * Postleitzahl S&adt
    * Name des Landes
    *
-   * @return std::string Menschenlesbare Zusammenfassung des Objektes
+   * @param buffer Puffer an den die menschenlesbare Zusammenfassung des
+   * Objektes angehängt wird.
    */
-  // TODO to_string Methode überschreiben
-  std::string to_string() const override;
+  void append_to(std::string &buffer) const override;
 };
@@ -0,0 +1,140 @@
+#include "validation.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static inline bool is_digit(char c)
+{
+	return static_cast<unsigned char>(c - '0') <= 9;
+}
+
+#if defined(__SSE2__)
+/*
+ * Liefert ein Bit je Zeichen der nächsten 16 Zeichen, gesetzt wenn das Zeichen
+ * eine Ziffer ist. Nach Abzug von '0' sind genau die Ziffern vorzeichenlos
+ * kleiner oder gleich 9.
+ */
+static inline std::uint64_t digit_mask(const char *data)
+{
+	__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+	__m128i shifted = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+	__m128i digits = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(9)), shifted);
+	return static_cast<std::uint32_t>(_mm_movemask_epi8(digits));
+}
+#endif
+
+std::size_t count_digits(std::string_view str)
+{
+	std::size_t count = 0;
+	std::size_t i = 0;
+#if defined(__SSE2__)
+	for(; i + 16 <= str.size(); i += 16)
+		count += __builtin_popcountll(digit_mask(str.data() + i));
+#endif
+	for(; i < str.size(); i++)
+		count += is_digit(str[i]);
+	return count;
+}
+
+/*
+ * Bestimmt für den ganzen Puffer ein Bit je Zeichen, gesetzt für Ziffern.
+ */
+static std::vector<std::uint64_t> digit_bits(const std::string &data)
+{
+	std::vector<std::uint64_t> bits((data.size() + 63) / 64, 0);
+	std::size_t i = 0;
+#if defined(__SSE2__)
+	for(; i + 64 <= data.size(); i += 64)
+	{
+		const char *chunk = data.data() + i;
+		bits[i / 64] = digit_mask(chunk) | digit_mask(chunk + 16) << 16
+			| digit_mask(chunk + 32) << 32 | digit_mask(chunk + 48) << 48;
+	}
+#endif
+	for(; i < data.size(); i++)
+	{
+		if(is_digit(data[i]))
+			bits[i / 64] |= std::uint64_t(1) << (i % 64);
+	}
+	return bits;
+}
+
+/*
+ * Zählt die gesetzten Bits zwischen begin und end.
+ */
+static std::size_t count_bits(const std::vector<std::uint64_t> &bits, std::size_t begin, std::size_t end)
+{
+	std::size_t count = 0;
+	while(begin < end)
+	{
+		std::size_t shift = begin % 64;
+		std::size_t length = std::min<std::size_t>(64 - shift, end - begin);
+		std::uint64_t word = bits[begin / 64] >> shift;
+		if(length < 64)
+			word &= (std::uint64_t(1) << length) - 1;
+		count += __builtin_popcountll(word);
+		begin += length;
+	}
+	return count;
+}
+
+std::size_t ErrorBitmap::count() const
+{
+	std::size_t count = 0;
+	for(std::uint64_t word : m_words)
+		count += __builtin_popcountll(word);
+	return count;
+}
+
+ErrorBitmap validate_persons(const PackedStrings &first_names, const PackedStrings &last_names,
+		const std::vector<Date> &birthdays)
+{
+	if(first_names.size() != last_names.size() || first_names.size() != birthdays.size())
+		throw std::domain_error("record columns differ in size");
+
+	Date today = Date::today();
+	std::vector<std::uint64_t> first_digits = digit_bits(first_names.data());
+	std::vector<std::uint64_t> last_digits = digit_bits(last_names.data());
+
+	ErrorBitmap errors(first_names.size());
+	for(std::size_t i = 0; i < first_names.size(); i++)
+	{
+		std::size_t first_begin = first_names.offset(i), first_end = first_names.offset(i + 1);
+		std::size_t last_begin = last_names.offset(i), last_end = last_names.offset(i + 1);
+
+		bool valid = first_end - first_begin >= 2 && last_end - last_begin >= 2
+			&& birthdays[i] <= today
+			&& count_bits(first_digits, first_begin, first_end) == 0
+			&& count_bits(last_digits, last_begin, last_end) == 0;
+		if(!valid)
+			errors.set(i);
+	}
+	return errors;
+}
+
+ErrorBitmap validate_addresses(const PackedStrings &streets, const std::vector<std::int32_t> &street_numbers,
+		const PackedStrings &zipcodes, const PackedStrings &cities, const PackedStrings &countries)
+{
+	std::size_t size = streets.size();
+	if(street_numbers.size() != size || zipcodes.size() != size || cities.size() != size
+		|| countries.size() != size)
+		throw std::domain_error("record columns differ in size");
+
+	std::vector<std::uint64_t> zipcode_digits = digit_bits(zipcodes.data());
+
+	ErrorBitmap errors(size);
+	for(std::size_t i = 0; i < size; i++)
+	{
+		std::size_t zip_begin = zipcodes.offset(i), zip_end = zipcodes.offset(i + 1);
+
+		bool valid = streets[i].size() >= 10 && street_numbers[i] > 0
+			&& zip_end - zip_begin == 5 && count_bits(zipcode_digits, zip_begin, zip_end) == 5
+			&& cities[i].size() >= 3 && countries[i].size() >= 3;
+		if(!valid)
+			errors.set(i);
+	}
+	return errors;
+}
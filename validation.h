@@ -0,0 +1,112 @@
+#pragma once
+#include "date.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Zählt die Ziffern '0' bis '9' in der Zeichenkette. Auf Maschinen mit
+ * SSE2 werden dabei 16 Zeichen auf einmal geprüft.
+ */
+std::size_t count_digits(std::string_view str);
+
+/**
+ * @brief Viele Zeichenketten hintereinander in einem gemeinsamen Puffer. Die
+ * Zeichenkette i liegt zwischen offset(i) und offset(i + 1), womit eine
+ * Spalte von Namen mit zwei Speicheranforderungen auskommt und am Stück
+ * geprüft werden kann.
+ */
+class PackedStrings {
+private:
+  std::string m_data;
+  std::vector<std::uint32_t> m_offsets;
+
+public:
+  PackedStrings() : m_offsets(1, 0) {}
+
+  /**
+   * @brief Reserviert Speicher für count Zeichenketten mit zusammen bytes
+   * Zeichen.
+   */
+  void reserve(std::size_t count, std::size_t bytes) {
+    m_offsets.reserve(count + 1);
+    m_data.reserve(bytes);
+  }
+
+  void push_back(std::string_view str) {
+    m_data.append(str.data(), str.size());
+    m_offsets.emplace_back(static_cast<std::uint32_t>(m_data.size()));
+  }
+
+  std::string_view operator[](std::size_t i) const {
+    return std::string_view(m_data.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+  }
+
+  std::size_t size() const { return m_offsets.size() - 1; }
+
+  const std::string &data() const { return m_data; }
+
+  std::uint32_t offset(std::size_t i) const { return m_offsets[i]; }
+};
+
+/**
+ * @brief Ein Bit je Datensatz, gesetzt wenn der Datensatz ungültig ist.
+ */
+class ErrorBitmap {
+private:
+  std::vector<std::uint64_t> m_words;
+  std::size_t m_size;
+
+public:
+  explicit ErrorBitmap(std::size_t size) : m_words((size + 63) / 64, 0), m_size(size) {}
+
+  void set(std::size_t i) { m_words[i / 64] |= std::uint64_t(1) << (i % 64); }
+
+  bool test(std::size_t i) const { return (m_words[i / 64] >> (i % 64)) & 1; }
+
+  /**
+   * @brief Markiert zusätzlich alle Datensätze welche in other ungültig sind,
+   * beide Bitmaps müssen gleich groß sein.
+   */
+  void merge(const ErrorBitmap &other) {
+    for (std::size_t i = 0; i < m_words.size(); i++)
+      m_words[i] |= other.m_words[i];
+  }
+
+  /**
+   * @return Die Anzahl der ungültigen Datensätze.
+   */
+  std::size_t count() const;
+
+  std::size_t size() const { return m_size; }
+
+  const std::vector<std::uint64_t> &words() const { return m_words; }
+};
+
+/**
+ * @brief Prüft viele Personendaten auf einmal nach denselben Regeln wie der
+ * Konstruktor von Person, ohne Exceptions zu werfen. Die Ziffern werden dabei
+ * einmal für den ganzen Puffer einer Spalte bestimmt, die Prüfung der
+ * einzelnen Namen zählt danach nur noch Bits.
+ *
+ * Die gültigen Datensätze können anschließend mit den Prevalidated
+ * Konstruktoren erzeugt werden.
+ *
+ * @param first_names Vornamen, mindestens 2 Zeichen und ohne Ziffern.
+ * @param last_names Nachnamen, mindestens 2 Zeichen und ohne Ziffern.
+ * @param birthdays Geburtstage, diese dürfen nicht in der Zukunft liegen.
+ * @return ErrorBitmap Die ungültigen Datensätze.
+ */
+ErrorBitmap validate_persons(const PackedStrings &first_names, const PackedStrings &last_names,
+    const std::vector<Date> &birthdays);
+
+/**
+ * @brief Prüft viele Adressen auf einmal nach denselben Regeln wie der
+ * Konstruktor von Address, ohne Exceptions zu werfen.
+ *
+ * @return ErrorBitmap Die ungültigen Datensätze.
+ */
+ErrorBitmap validate_addresses(const PackedStrings &streets, const std::vector<std::int32_t> &street_numbers,
+    const PackedStrings &zipcodes, const PackedStrings &cities, const PackedStrings &countries);
@@ -0,0 +1,275 @@
+#include "versioned_view.h"
+#include "formatting.h"
+#include "persons.h"
+#include "university.h"
+#include <algorithm>
+#include <atomic>
+
+/*
+ * Liefert den Teil zum Verändern. Hält noch eine Version den Teil, wird er
+ * vorher kopiert. Versionen erhalten ihre Zeiger nur unter der Sperre der
+ * Sicht, ein Teil mit nur einem Besitzer kann deshalb von keinem Lesenden
+ * gesehen werden.
+ */
+template <typename T> static T &writable(std::shared_ptr<T> &part)
+{
+	if(part.use_count() > 1)
+		part = std::make_shared<T>(*part);
+	else
+		// Der letzte Lesende hat seinen Zeiger eventuell gerade erst
+		// freigegeben, seine Zugriffe müssen vor unseren liegen.
+		std::atomic_thread_fence(std::memory_order_acquire);
+	return *part;
+}
+
+static void append_person(std::string &buffer, const VersionedPerson &person)
+{
+	buffer += *person.first_name;
+	buffer += ' ';
+	buffer += *person.last_name;
+}
+
+VersionedPerson VersionedPerson::of(const Person &person, std::int32_t number)
+{
+	return VersionedPerson{number, &person.first_name(), &person.last_name()};
+}
+
+void VersionedCourse::append_to(std::string &buffer) const
+{
+	buffer += "Seminar: ";
+	buffer += name;
+	buffer += "\n\nLehrkraft: ";
+	if(teacher.number != 0)
+		append_person(buffer, teacher);
+
+	buffer += "\n\nAnzahl Studierende: ";
+	append_number(buffer, students.size());
+	buffer += '\n';
+	for(std::size_t i = 0; i < students.size(); i++)
+		append_roster_line(buffer, i + 1, *students[i].first_name, *students[i].last_name);
+}
+
+void UniversityVersion::append_people(std::string &buffer, const std::vector<std::shared_ptr<const Chunk>> &chunks)
+{
+	std::size_t i = 0;
+	for(const std::shared_ptr<const Chunk> &chunk : chunks)
+	{
+		for(const VersionedPerson &person : *chunk)
+			append_roster_line(buffer, ++i, *person.first_name, *person.last_name);
+	}
+}
+
+void UniversityVersion::append_to(std::string &buffer) const
+{
+	buffer += "Universität: ";
+	buffer += m_name;
+	buffer += "\n\n";
+	m_address->append_to(buffer);
+
+	buffer += "Anzahl Studierender: ";
+	append_number(buffer, m_student_count);
+	buffer += '\n';
+	append_people(buffer, m_students);
+
+	buffer += "\nAnzahl Lehrkräfte: ";
+	append_number(buffer, m_teacher_count);
+	buffer += '\n';
+	append_people(buffer, m_teachers);
+
+	buffer += "\nAnzahl Seminare: ";
+	append_number(buffer, m_courses.size());
+	buffer += '\n';
+	for(std::size_t i = 0; i < m_courses.size(); i++)
+		append_roster_line(buffer, i + 1, m_courses[i]->name);
+}
+
+VersionedView::VersionedView(University &university):
+	m_university(university), m_address(std::make_shared<const Address>(university.address())),
+	m_student_count(0), m_teacher_count(0), m_version(0)
+{
+	for(Student *student : university.list_students())
+		m_student_count += insert(m_students, VersionedPerson::of(*student, student->student_number()));
+	for(Teacher *teacher : university.list_teachers())
+		m_teacher_count += insert(m_teachers, VersionedPerson::of(*teacher, teacher->staff_number()));
+	for(Course *course : university.list_courses())
+	{
+		course_offered(*course);
+		VersionedCourse &entry = *m_courses.back();
+		if(Teacher *teacher = course->teacher())
+			entry.teacher = VersionedPerson::of(*teacher, teacher->staff_number());
+		for(Student *student : course->list_students())
+			entry.students.emplace_back(VersionedPerson::of(*student, student->student_number()));
+		std::sort(entry.students.begin(), entry.students.end());
+	}
+	m_university.add_listener(*this);
+}
+
+VersionedView::~VersionedView()
+{
+	m_university.remove_listener(*this);
+}
+
+bool VersionedView::insert(std::map<std::int32_t, std::shared_ptr<Chunk>> &chunks, const VersionedPerson &person)
+{
+	std::shared_ptr<Chunk> &chunk = chunks[person.number / s_chunk];
+	if(!chunk)
+		chunk = std::make_shared<Chunk>();
+
+	auto it = std::lower_bound(chunk->begin(), chunk->end(), person);
+	if(it != chunk->end() && it->number == person.number)
+		return false;
+	std::size_t pos = it - chunk->begin();
+	Chunk &entries = writable(chunk);
+	entries.insert(entries.begin() + pos, person);
+	return true;
+}
+
+bool VersionedView::erase(std::map<std::int32_t, std::shared_ptr<Chunk>> &chunks, std::int32_t number)
+{
+	auto found = chunks.find(number / s_chunk);
+	if(found == chunks.end())
+		return false;
+
+	std::shared_ptr<Chunk> &chunk = found->second;
+	auto it = std::lower_bound(chunk->begin(), chunk->end(), VersionedPerson{number, NULL, NULL});
+	if(it == chunk->end() || it->number != number)
+		return false;
+	std::size_t pos = it - chunk->begin();
+	Chunk &entries = writable(chunk);
+	entries.erase(entries.begin() + pos);
+	if(entries.empty())
+		chunks.erase(found);
+	return true;
+}
+
+VersionedCourse *VersionedView::course(const Course &course)
+{
+	auto it = m_course_index.find(course.id());
+	if(it == m_course_index.end())
+		return NULL;
+	return &writable(m_courses[it->second]);
+}
+
+std::shared_ptr<const UniversityVersion> VersionedView::snapshot() const
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(m_current && m_current->m_version == m_version)
+		return m_current;
+
+	std::shared_ptr<UniversityVersion> version = std::make_shared<UniversityVersion>();
+	version->m_version = m_version;
+	version->m_name = m_university.name();
+	version->m_address = m_address;
+	version->m_students.reserve(m_students.size());
+	for(const std::pair<const std::int32_t, std::shared_ptr<Chunk>> &chunk : m_students)
+		version->m_students.emplace_back(chunk.second);
+	version->m_teachers.reserve(m_teachers.size());
+	for(const std::pair<const std::int32_t, std::shared_ptr<Chunk>> &chunk : m_teachers)
+		version->m_teachers.emplace_back(chunk.second);
+	version->m_courses.assign(m_courses.begin(), m_courses.end());
+	version->m_student_count = m_student_count;
+	version->m_teacher_count = m_teacher_count;
+	m_current = version;
+	return m_current;
+}
+
+void VersionedView::enrolled(const Student &student)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(insert(m_students, VersionedPerson::of(student, student.student_number())))
+	{
+		m_student_count++;
+		m_version++;
+	}
+}
+
+void VersionedView::exmatriculated(const Student &student)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(erase(m_students, student.student_number()))
+	{
+		m_student_count--;
+		m_version++;
+	}
+}
+
+void VersionedView::hired(const Teacher &teacher, std::int32_t)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(insert(m_teachers, VersionedPerson::of(teacher, teacher.staff_number())))
+	{
+		m_teacher_count++;
+		m_version++;
+	}
+}
+
+void VersionedView::laid_off(const Teacher &teacher)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(erase(m_teachers, teacher.staff_number()))
+	{
+		m_teacher_count--;
+		m_version++;
+	}
+}
+
+void VersionedView::course_offered(const Course &course)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(m_course_index.count(course.id()))
+		return;
+
+	std::shared_ptr<VersionedCourse> entry = std::make_shared<VersionedCourse>();
+	entry->id = course.id();
+	entry->name = course.name();
+	entry->teacher = VersionedPerson{0, NULL, NULL};
+	m_course_index.emplace(course.id(), m_courses.size());
+	m_courses.emplace_back(entry);
+	m_version++;
+}
+
+void VersionedView::enlisted(const Course &course, const Student &student)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	VersionedCourse *entry = this->course(course);
+	if(entry == NULL)
+		return;
+
+	VersionedPerson person = VersionedPerson::of(student, student.student_number());
+	entry->students.insert(std::lower_bound(entry->students.begin(), entry->students.end(), person), person);
+	m_version++;
+}
+
+void VersionedView::left(const Course &course, const Student &student)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	VersionedCourse *entry = this->course(course);
+	if(entry == NULL)
+		return;
+
+	auto it = std::lower_bound(entry->students.begin(), entry->students.end(),
+		VersionedPerson{student.student_number(), NULL, NULL});
+	if(it != entry->students.end() && it->number == student.student_number())
+		entry->students.erase(it);
+	m_version++;
+}
+
+void VersionedView::teacher_assigned(const Course &course, const Teacher &teacher)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(VersionedCourse *entry = this->course(course))
+	{
+		entry->teacher = VersionedPerson::of(teacher, teacher.staff_number());
+		m_version++;
+	}
+}
+
+void VersionedView::teacher_resigned(const Course &course, const Teacher &)
+{
+	std::lock_guard<std::mutex> guard(m_lock);
+	if(VersionedCourse *entry = this->course(course))
+	{
+		entry->teacher = VersionedPerson{0, NULL, NULL};
+		m_version++;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include "listener.h"
+#include "traits.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Address;
+class Person;
+class University;
+
+/**
+ * @brief Person in einer Version, die Namen verweisen in den prozessweiten
+ * StringPool und bleiben damit auch nach dem Löschen der Person gültig.
+ */
+struct VersionedPerson {
+  std::int32_t number;
+  const std::string *first_name;
+  const std::string *last_name;
+
+  static VersionedPerson of(const Person &person, std::int32_t number);
+
+  bool operator<(const VersionedPerson &other) const { return number < other.number; }
+};
+
+/**
+ * @brief Seminar in einer Version mit Lehrkraft und den eingeschriebenen
+ * Studierenden nach Matrikelnummer sortiert. Ohne Lehrkraft ist
+ * teacher.number 0.
+ */
+struct VersionedCourse : public Displayable {
+  std::uint32_t id;
+  std::string name;
+  VersionedPerson teacher;
+  std::vector<VersionedPerson> students;
+
+  /**
+   * @brief Hängt die Darstellung im Format von Course::append_to an.
+   */
+  void append_to(std::string &buffer) const override;
+};
+
+/**
+ * @brief Unveränderlicher Stand einer Universität zu einem Zeitpunkt, erzeugt
+ * von VersionedView::snapshot(). Eine Version kann ohne Sperren von beliebig
+ * vielen Threads gelesen werden, auch während die Universität verändert wird.
+ * Studierende und Lehrkräfte sind nach ihrer Nummer sortiert, Seminare stehen
+ * in der Reihenfolge ihres Angebots.
+ */
+class UniversityVersion : public Displayable {
+  friend class VersionedView;
+
+public:
+  typedef std::vector<VersionedPerson> Chunk;
+
+private:
+  std::uint64_t m_version;
+  std::string m_name;
+  std::shared_ptr<const Address> m_address;
+  std::vector<std::shared_ptr<const Chunk>> m_students;
+  std::vector<std::shared_ptr<const Chunk>> m_teachers;
+  std::vector<std::shared_ptr<const VersionedCourse>> m_courses;
+  std::size_t m_student_count;
+  std::size_t m_teacher_count;
+
+  static void append_people(std::string &buffer, const std::vector<std::shared_ptr<const Chunk>> &chunks);
+
+public:
+  /**
+   * @return Fortlaufende Nummer der Version, spätere Versionen haben größere
+   * Nummern.
+   */
+  std::uint64_t version() const { return m_version; }
+
+  const std::string &name() const { return m_name; }
+
+  std::size_t student_count() const { return m_student_count; }
+
+  std::size_t teacher_count() const { return m_teacher_count; }
+
+  /**
+   * @brief Ruft die Funktion für alle Studierenden in der Reihenfolge ihrer
+   * Matrikelnummer auf.
+   */
+  template <typename F> void for_each_student(F function) const {
+    for (const std::shared_ptr<const Chunk> &chunk : m_students)
+      for (const VersionedPerson &student : *chunk)
+        function(student);
+  }
+
+  /**
+   * @brief Ruft die Funktion für alle Lehrkräfte in der Reihenfolge ihrer
+   * Personalnummer auf.
+   */
+  template <typename F> void for_each_teacher(F function) const {
+    for (const std::shared_ptr<const Chunk> &chunk : m_teachers)
+      for (const VersionedPerson &teacher : *chunk)
+        function(teacher);
+  }
+
+  /**
+   * @return Alle Seminare in der Reihenfolge ihres Angebots.
+   */
+  const std::vector<std::shared_ptr<const VersionedCourse>> &courses() const { return m_courses; }
+
+  /**
+   * @brief Hängt die Darstellung im Format von University::append_to an.
+   */
+  void append_to(std::string &buffer) const override;
+};
+
+/**
+ * @brief Liefert lesbare Stände (Versionen) einer Universität für lange
+ * Auswertungen wie Berichte, ohne die Einschreibungen zu blockieren. Die
+ * Sicht meldet sich als MutationListener an und führt eine eigene Kopie der
+ * Mitglieder und Seminare, deren Teile mit Copy-on-Write zwischen den
+ * Versionen geteilt werden.
+ *
+ * Studierende und Lehrkräfte liegen in Blöcken zu je s_chunk Nummern, jedes
+ * Seminar ist ein eigener Teil. Eine Veränderung verändert ihren Teil direkt,
+ * solange keine Version ihn hält, sonst wird nur dieser Teil kopiert und die
+ * Kopie verändert. snapshot() kopiert nur die Zeiger auf die Teile und nur
+ * wenn sich seit der letzten Version etwas geändert hat. Schreibende zahlen
+ * damit je Teil und Version höchstens eine Kopie, Lesende nach dem Abholen
+ * der Version gar nichts mehr.
+ *
+ * Wartelisten und Zeiträume sind nicht Teil der Versionen. Die Sicht muss vor
+ * der Universität zerstört werden, Versionen dürfen sie überleben.
+ */
+class VersionedView : public MutationListener {
+public:
+  static constexpr std::int32_t s_chunk = 1024;
+
+private:
+  typedef UniversityVersion::Chunk Chunk;
+
+  University &m_university;
+  std::shared_ptr<const Address> m_address;
+  mutable std::mutex m_lock;
+  std::map<std::int32_t, std::shared_ptr<Chunk>> m_students;
+  std::map<std::int32_t, std::shared_ptr<Chunk>> m_teachers;
+  std::vector<std::shared_ptr<VersionedCourse>> m_courses;
+  std::unordered_map<std::uint32_t, std::size_t> m_course_index;
+  std::size_t m_student_count;
+  std::size_t m_teacher_count;
+  std::uint64_t m_version;
+  mutable std::shared_ptr<const UniversityVersion> m_current;
+
+  static bool insert(std::map<std::int32_t, std::shared_ptr<Chunk>> &chunks, const VersionedPerson &person);
+  static bool erase(std::map<std::int32_t, std::shared_ptr<Chunk>> &chunks, std::int32_t number);
+  VersionedCourse *course(const Course &course);
+
+public:
+  /**
+   * @brief Übernimmt den Bestand der Universität und meldet die Sicht an.
+   */
+  explicit VersionedView(University &university);
+
+  VersionedView(const VersionedView &) = delete;
+  VersionedView &operator=(const VersionedView &) = delete;
+
+  /**
+   * @brief Meldet die Sicht von der Universität ab.
+   */
+  virtual ~VersionedView();
+
+  /**
+   * @brief Threadsicher, blockiert nur für das Kopieren der Zeiger auf die
+   * veränderten Teile.
+   *
+   * @return Der aktuelle Stand der Universität. Ohne Veränderungen seit dem
+   * letzten Aufruf dieselbe Version.
+   */
+  std::shared_ptr<const UniversityVersion> snapshot() const;
+
+  void enrolled(const Student &student) override;
+  void exmatriculated(const Student &student) override;
+  void hired(const Teacher &teacher, std::int32_t loan) override;
+  void laid_off(const Teacher &teacher) override;
+  void course_offered(const Course &course) override;
+  void enlisted(const Course &course, const Student &student) override;
+  void left(const Course &course, const Student &student) override;
+  void teacher_assigned(const Course &course, const Teacher &teacher) override;
+  void teacher_resigned(const Course &course, const Teacher &teacher) override;
+};
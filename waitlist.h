@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+
+/**
+ * @brief Nach Priorität geordnete Warteliste von Objekten mit eindeutigem
+ * Schlüssel. Kleinere Prioritätswerte stehen weiter vorne, bei gleicher
+ * Priorität entscheidet die Reihenfolge des Eintragens.
+ *
+ * Die Einträge liegen in einem balancierten Suchbaum, eine Hashtabelle bildet
+ * den Schlüssel auf den Eintrag im Baum ab. Eintragen und Entfernen beliebiger
+ * Einträge kosten damit O(log n), der Zugriff auf den ersten Eintrag und die
+ * Mitgliedschaftsprüfung O(1).
+ */
+template <typename Key, typename T> class Waitlist {
+public:
+  struct Entry {
+    std::int64_t priority;
+    std::uint64_t sequence;
+    Key key;
+    T *item;
+
+    bool operator<(const Entry &other) const {
+      if (priority != other.priority)
+        return priority < other.priority;
+      return sequence < other.sequence;
+    }
+  };
+
+private:
+  std::set<Entry> m_entries;
+  std::unordered_map<Key, typename std::set<Entry>::iterator> m_index;
+  std::uint64_t m_sequence = 0;
+
+public:
+  /**
+   * @brief Trägt das Objekt mit der Priorität ein, falls der Schlüssel noch
+   * nicht auf der Warteliste steht.
+   *
+   * @return true Wenn das Objekt eingetragen wurde.
+   */
+  bool push(const Key &key, T *item, std::int64_t priority) {
+    auto result = m_index.emplace(key, m_entries.end());
+    if (!result.second)
+      return false;
+    result.first->second = m_entries.insert(m_entries.end(), Entry{priority, m_sequence++, key, item});
+    return true;
+  }
+
+  /**
+   * @brief Entfernt den Eintrag mit dem Schlüssel, falls er existiert.
+   *
+   * @return true Wenn ein Eintrag entfernt wurde.
+   */
+  bool erase(const Key &key) {
+    auto it = m_index.find(key);
+    if (it == m_index.end())
+      return false;
+    m_entries.erase(it->second);
+    m_index.erase(it);
+    return true;
+  }
+
+  /**
+   * @return Der erste Eintrag der Warteliste, diese darf nicht leer sein.
+   */
+  const Entry &front() const { return *m_entries.begin(); }
+
+  /**
+   * @brief Entfernt den ersten Eintrag, die Warteliste darf nicht leer sein.
+   */
+  void pop_front() {
+    m_index.erase(m_entries.begin()->key);
+    m_entries.erase(m_entries.begin());
+  }
+
+  bool contains(const Key &key) const { return m_index.count(key) != 0; }
+
+  std::size_t size() const { return m_entries.size(); }
+
+  bool empty() const { return m_entries.empty(); }
+
+  /**
+   * @return Alle Einträge in der Reihenfolge in welcher sie nachrücken.
+   */
+  const std::set<Entry> &entries() const { return m_entries; }
+};